@@ -1162,6 +1162,8 @@ BuildResult BuildLevel(int level_index)
     {
         BoundingBox dummy;
 
+        StartNodeWorkers();
+
         // create initial segs
         Seg *list = CreateSegs();
 
@@ -458,6 +458,10 @@ Seg *CreateSegs(void);
 // returns kBuildOK, or BUILD_Cancelled if user stopped it.
 BuildResult BuildNodes(Seg *list, int depth, BoundingBox *bounds /* output */, Node **N, Subsector **S);
 
+// create the thread pool used to evaluate partition candidates.  Safe to
+// call more than once; the pool lives until the program exits.
+void StartNodeWorkers();
+
 // compute the height of the bsp tree, starting at 'node'.
 int ComputeBSPHeight(const Node *node);
 
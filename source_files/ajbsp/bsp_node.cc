@@ -18,10 +18,13 @@
 //
 //------------------------------------------------------------------------
 
+#include <atomic>
+
 #include "HandmadeMath.h"
 #include "bsp_local.h"
 #include "bsp_utility.h"
 #include "bsp_wad.h"
+#include "epi_thread.h"
 
 #define AJBSP_DEBUG_PICKNODE 0
 #define AJBSP_DEBUG_SPLIT    0
@@ -34,6 +37,9 @@
 static constexpr uint8_t kPreciousCostMultiplier = 100;
 static constexpr uint8_t kSegFastModeThreshold   = 200;
 
+// seg groups smaller than this are not worth handing out to the workers
+static constexpr uint8_t kSegParallelPickThreshold = 64;
+
 //
 // To be able to divide the nodes down, this routine must decide which
 // is the best Seg to use as a nodeline. It does this by selecting the
@@ -654,6 +660,132 @@ bool PickNodeWorker(QuadTree *part_list, QuadTree *tree, Seg **best, double *bes
     return true;
 }
 
+//
+// Parallel partition picking.
+//
+// The candidates are collected in the same order PickNodeWorker() visits
+// them and dealt out to the node workers.  Each job keeps its own best
+// seg, while the cheapest cost found so far is shared so that every job
+// can prune with it.  A seg with the lowest cost is never pruned (its
+// partial cost cannot exceed the final one), hence the winner is the
+// lowest cost with ties going to the earliest candidate, exactly like
+// the serial picker.  This keeps the XWA output reproducible.
+//
+
+static epi::WorkerPool *node_workers = nullptr;
+
+static void CollectPartitionCandidates(QuadTree *part_list, std::vector<Seg *> &candidates)
+{
+    for (Seg *part = part_list->list_; part; part = part->next_)
+    {
+        /* ignore minisegs as partition candidates */
+        if (part->linedef_ != nullptr)
+            candidates.push_back(part);
+    }
+
+    for (int c = 0; c < 2; c++)
+    {
+        if (part_list->subs_[c] != nullptr && !part_list->subs_[c]->Empty())
+            CollectPartitionCandidates(part_list->subs_[c], candidates);
+    }
+}
+
+class PickNodeJob : public epi::WorkerJob
+{
+  public:
+    QuadTree                 *tree_;
+    const std::vector<Seg *> *candidates_;
+    std::atomic<double>      *shared_cost_;
+
+    size_t first_;
+    size_t step_;
+
+    // results
+    Seg   *best_;
+    double best_cost_;
+    size_t best_index_;
+
+  public:
+    void Run() override
+    {
+        best_       = nullptr;
+        best_cost_  = 1.0e99;
+        best_index_ = 0;
+
+        for (size_t i = first_; i < candidates_->size(); i += step_)
+        {
+            Seg *part = (*candidates_)[i];
+
+            double cost = EvalPartition(tree_, part, shared_cost_->load(std::memory_order_relaxed));
+
+            /* seg unsuitable or too costly ? */
+            if (cost < 0 || cost >= best_cost_)
+                continue;
+
+            best_       = part;
+            best_cost_  = cost;
+            best_index_ = i;
+
+            // lower the shared bound for everybody else
+            double shared = shared_cost_->load(std::memory_order_relaxed);
+
+            while (cost < shared && !shared_cost_->compare_exchange_weak(shared, cost, std::memory_order_relaxed))
+            {
+            }
+        }
+    }
+};
+
+static Seg *PickNodeParallel(QuadTree *tree)
+{
+    std::vector<Seg *> candidates;
+
+    CollectPartitionCandidates(tree, candidates);
+
+    int job_count = node_workers->GetThreadCount() + 1;
+
+    std::atomic<double> shared_cost(1.0e99);
+
+    std::vector<PickNodeJob> jobs(job_count);
+
+    for (int k = 0; k < job_count; k++)
+    {
+        jobs[k].tree_        = tree;
+        jobs[k].candidates_  = &candidates;
+        jobs[k].shared_cost_ = &shared_cost;
+        jobs[k].first_       = k;
+        jobs[k].step_        = job_count;
+    }
+
+    // the last job runs on this thread
+    for (int k = 0; k < job_count - 1; k++)
+        node_workers->Add(&jobs[k]);
+
+    jobs[job_count - 1].Run();
+
+    for (int k = 0; k < job_count - 1; k++)
+        node_workers->Wait(&jobs[k]);
+
+    Seg   *best       = nullptr;
+    double best_cost  = 1.0e99;
+    size_t best_index = 0;
+
+    for (int k = 0; k < job_count; k++)
+    {
+        if (jobs[k].best_ == nullptr)
+            continue;
+
+        if (jobs[k].best_cost_ < best_cost || (jobs[k].best_cost_ == best_cost && jobs[k].best_index_ < best_index))
+        {
+            best       = jobs[k].best_;
+            best_cost  = jobs[k].best_cost_;
+            best_index = jobs[k].best_index_;
+        }
+    }
+
+    return best;
+}
+
 //
 // Find the best seg in the seg_list to use as a partition line.
 //
@@ -689,6 +821,12 @@ static Seg *PickNode(QuadTree *tree)
         }
     }
 
+    if (node_workers != nullptr && node_workers->GetThreadCount() > 0 &&
+        tree->real_num_ + tree->mini_num_ >= kSegParallelPickThreshold)
+    {
+        return PickNodeParallel(tree);
+    }
+
     if (!PickNodeWorker(tree, tree, &best, &best_cost))
     {
         /* hack here : BuildNodes will detect the cancellation */
@@ -1568,6 +1706,11 @@ BuildResult BuildNodes(Seg *list, int depth, BoundingBox *bounds /* output */, N
 
     BuildResult ret;
 
+    // NOTE: the two halves cannot be built concurrently.  Splitting a seg
+    //       also splits its partner, which may live in the other half
+    //       (every miniseg pair straddles the partition), so each side
+    //       can modify the seg lists of the other.
+
     // recursively build the left side
     ret = BuildNodes(lefts, depth + 1, &node->l_.bounds, &node->l_.node, &node->l_.subsec);
     if (ret != kBuildOK)
@@ -1589,6 +1732,12 @@ BuildResult BuildNodes(Seg *list, int depth, BoundingBox *bounds /* output */, N
     return kBuildOK;
 }
 
+void StartNodeWorkers()
+{
+    if (node_workers == nullptr)
+        node_workers = new epi::WorkerPool();
+}
+
 void ClockwiseBSPTree()
 {
     int cur_seg_index = 0;
@@ -837,7 +837,7 @@ void RealVM::STATReturn(void)
         LexExpect(";");
 }
 
-Definition *RealVM::FindDef(Type *type, char *name, Scope *scope)
+Definition *RealVM::FindDef(Type *type, const char *name, Scope *scope)
 {
     for (Definition *def = scope->names_; def; def = def->next)
     {
@@ -1489,6 +1489,8 @@ void RealVM::GLOBFunction()
     df->source_file = strdup(comp_.source_file);
     df->source_line = comp_.source_line;
 
+    function_index_[df->name] = (int)functions_.size() - 1;
+
     int stack_ofs = 0;
 
     df->return_size = type_size[def->type->aux_type->type];
@@ -1739,6 +1741,9 @@ bool RealVM::CompileFile(char *buffer, const char *filename)
 
     comp_.source_file = nullptr;
 
+    // new code (and patched jumps) must be picked up by the interpreter
+    threaded_code_.clear();
+
     return (comp_.error_count == 0);
 }
 
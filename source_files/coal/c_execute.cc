@@ -32,6 +32,7 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <string>
 #include <vector>
 
 #include "AlmostEquals.h"
@@ -88,22 +89,55 @@ void RealVM::SetTrace(bool enable)
 
 int RealVM::FindFunction(const char *func_name)
 {
-    for (int i = (int)functions_.size() - 1; i >= 1; i--)
+    std::unordered_map<std::string, int>::const_iterator iter = function_index_.find(func_name);
+
+    if (iter == function_index_.end())
+        return VM::NOT_FOUND;
+
+    return iter->second;
+}
+
+int RealVM::FindVariable(const char *var_name)
+{
+    Scope *scope = &comp_.global_scope;
+
+    const char *dot = strchr(var_name, '.');
+
+    if (dot)
     {
-        Function *f = functions_[i];
+        std::string mod_name(var_name, dot - var_name);
 
-        if (strcmp(f->name, func_name) == 0)
-            return i;
+        Definition *mod_def = FindDef(nullptr, mod_name.c_str(), scope);
+        if (!mod_def || mod_def->type->type != ev_module)
+            return VM::NOT_FOUND;
+
+        scope = comp_.all_modules[mod_def->ofs];
+        var_name = dot + 1;
     }
 
-    return VM::NOT_FOUND;
+    Definition *var = FindDef(nullptr, var_name, scope);
+
+    if (!var || var->ofs <= 0)
+        return VM::NOT_FOUND;
+
+    switch (var->type->type)
+    {
+    case ev_float:
+    case ev_vector:
+    case ev_string:
+        return var->ofs;
+
+    default:
+        return VM::NOT_FOUND;
+    }
 }
 
-int RealVM::FindVariable(const char *var_name)
+double *RealVM::AccessVariable(int var_handle)
 {
-    // FIXME
-    EPI_UNUSED(var_name);
-    return VM::NOT_FOUND;
+    if (var_handle <= 0)
+        return nullptr;
+
+    return COAL_REF_GLOBAL(var_handle);
 }
 
 // returns an offset from the string heap
@@ -316,7 +350,550 @@ void RealVM::EnterNative(int func, int argc)
 #define COAL_OPERAND(a)                                                                                                \
     (((a) > 0) ? COAL_REF_GLOBAL(a) : ((a) < 0) ? &exec_.stack[exec_.stack_depth - ((a) + 1)] : nullptr)
 
+//
+// Threaded code
+//
+// Before running anything, the statements in op_mem_ are copied into
+// one flat array (so fetching is a plain index), and some common pairs
+// of instructions are replaced by a single fused operation:
+//
+//   compare + IF/IFNOT on its result  (conditions of if/while/for)
+//   PARM_F + CALL                     (the last parameter of a call)
+//
+// The second statement of a pair stays where it is, since jumps may
+// land on it directly, and a fused operation simply steps over it.
+// The operations below only ever appear in threaded_code_.
+//
+enum ThreadedOperation
+{
+    OPX_LT_IFNOT = NUM_OPERATIONS,
+    OPX_LE_IFNOT,
+    OPX_GT_IFNOT,
+    OPX_GE_IFNOT,
+    OPX_EQ_F_IFNOT,
+    OPX_NE_F_IFNOT,
+
+    OPX_LT_IF,
+    OPX_LE_IF,
+    OPX_GT_IF,
+    OPX_GE_IF,
+    OPX_EQ_F_IF,
+    OPX_NE_F_IF,
+
+    OPX_PARM_F_CALL,
+
+    // unknown opcodes are mapped to this (reported when reached)
+    OPX_BAD_OPCODE,
+
+    NUM_THREADED_OPERATIONS
+};
+
+static int FusedCompareOp(int compare, int branch)
+{
+    int base = (branch == OP_IFNOT) ? OPX_LT_IFNOT : OPX_LT_IF;
+
+    switch (compare)
+    {
+    case OP_LT:
+        return base + 0;
+    case OP_LE:
+        return base + 1;
+    case OP_GT:
+        return base + 2;
+    case OP_GE:
+        return base + 3;
+    case OP_EQ_F:
+        return base + 4;
+    case OP_NE_F:
+        return base + 5;
+    default:
+        return -1;
+    }
+}
+
+void RealVM::BuildThreadedCode()
+{
+    int total = comp_.last_statement / (int)sizeof(Statement) + 1;
+
+    threaded_code_.resize(total);
+
+    // statements are allocated back to back (whole blocks of them),
+    // hence offset / sizeof(Statement) is the statement's index.
+    for (int i = 0; i < total; i++)
+    {
+        threaded_code_[i] = *COAL_REF_OP(i * (int)sizeof(Statement));
+
+        if (threaded_code_[i].op < 0 || threaded_code_[i].op >= NUM_OPERATIONS)
+            threaded_code_[i].op = OPX_BAD_OPCODE;
+    }
+
+    for (int i = 0; i + 1 < total; i++)
+    {
+        Statement *st   = &threaded_code_[i];
+        Statement *next = &threaded_code_[i + 1];
+
+        if ((next->op == OP_IF || next->op == OP_IFNOT) && next->a == st->c && st->c != 0)
+        {
+            int fused = FusedCompareOp(st->op, next->op);
+
+            if (fused >= 0)
+                st->op = (int16_t)fused;
+        }
+        else if (st->op == OP_PARM_F && next->op == OP_CALL)
+        {
+            st->op = OPX_PARM_F_CALL;
+        }
+    }
+}
+
 void RealVM::DoExecute(int fnum)
+{
+    // tracing is handled by a separate (slow) loop
+    if (exec_.tracing)
+    {
+        DoExecuteTraced(fnum);
+        return;
+    }
+
+    if (threaded_code_.empty())
+        BuildThreadedCode();
+
+    const Statement *code = threaded_code_.data();
+
+    int runaway = kMaximumRunaway;
+
+    // make a stack frame
+    int exitdepth = exec_.call_depth;
+
+    EnterFunction(fnum);
+
+    const Statement *st;
+
+    double *a;
+    double *b;
+    double *c;
+
+#if defined(__GNUC__) || defined(__clang__)
+#define COAL_COMPUTED_GOTO
+#endif
+
+#ifdef COAL_COMPUTED_GOTO
+    static void *const dispatch[] = {
+        &&label_OP_NULL,        &&label_OP_CALL,        &&label_OP_RET,          &&label_OP_PARM_NULL,
+        &&label_OP_PARM_F,      &&label_OP_PARM_V,      &&label_OP_IF,           &&label_OP_IFNOT,
+        &&label_OP_GOTO,        &&label_OP_ERROR,       &&label_OP_MOVE_F,       &&label_OP_MOVE_V,
+        &&label_OP_MOVE_S,      &&label_OP_MOVE_FNC,    &&label_OP_NOT_F,        &&label_OP_NOT_V,
+        &&label_OP_NOT_S,       &&label_OP_NOT_FNC,     &&label_OP_INC,          &&label_OP_DEC,
+        &&label_OP_POWER_F,     &&label_OP_MUL_F,       &&label_OP_MUL_V,        &&label_OP_MUL_FV,
+        &&label_OP_MUL_VF,      &&label_OP_DIV_F,       &&label_OP_DIV_V,        &&label_OP_MOD_F,
+        &&label_OP_ADD_F,       &&label_OP_ADD_V,       &&label_OP_ADD_S,        &&label_OP_ADD_SF,
+        &&label_OP_ADD_SV,      &&label_OP_SUB_F,       &&label_OP_SUB_V,        &&label_OP_EQ_F,
+        &&label_OP_EQ_V,        &&label_OP_EQ_S,        &&label_OP_EQ_FNC,       &&label_OP_NE_F,
+        &&label_OP_NE_V,        &&label_OP_NE_S,        &&label_OP_NE_FNC,       &&label_OP_LE,
+        &&label_OP_GE,          &&label_OP_LT,          &&label_OP_GT,           &&label_OP_AND,
+        &&label_OP_OR,          &&label_OP_BITAND,      &&label_OP_BITOR,        &&label_OPX_LT_IFNOT,
+        &&label_OPX_LE_IFNOT,   &&label_OPX_GT_IFNOT,   &&label_OPX_GE_IFNOT,    &&label_OPX_EQ_F_IFNOT,
+        &&label_OPX_NE_F_IFNOT, &&label_OPX_LT_IF,      &&label_OPX_LE_IF,       &&label_OPX_GT_IF,
+        &&label_OPX_GE_IF,      &&label_OPX_EQ_F_IF,    &&label_OPX_NE_F_IF,     &&label_OPX_PARM_F_CALL,
+        &&label_OPX_BAD_OPCODE,
+    };
+
+    static_assert(sizeof(dispatch) / sizeof(dispatch[0]) == NUM_THREADED_OPERATIONS, "COAL dispatch table size");
+
+#define COAL_CASE(op)                                                                                                  \
+    case op:                                                                                                           \
+    label_##op:
+#else
+#define COAL_CASE(op) case op:
+#endif
+
+#define COAL_DECODE_ABC()                                                                                              \
+    a = COAL_OPERAND(st->a);                                                                                           \
+    b = COAL_OPERAND(st->b);                                                                                           \
+    c = COAL_OPERAND(st->c)
+
+    // compare, then branch on the result and skip the IF/IFNOT
+#define COAL_FUSED_COMPARE(op, expr, branch_if)                                                                        \
+    COAL_CASE(op)                                                                                                      \
+    {                                                                                                                  \
+        COAL_DECODE_ABC();                                                                                             \
+        *c = (expr);                                                                                                   \
+        if (!--runaway)                                                                                                \
+            RunError("runaway loop error");                                                                            \
+        if ((*c != 0) == (branch_if))                                                                                  \
+            exec_.s = st[1].b;                                                                                         \
+        else                                                                                                           \
+            exec_.s += sizeof(Statement);                                                                              \
+        continue;                                                                                                      \
+    }
+
+    for (;;)
+    {
+        st = &code[exec_.s / (int)sizeof(Statement)];
+
+        if (!--runaway)
+            RunError("runaway loop error");
+
+        // move code pointer to next statement
+        exec_.s += sizeof(Statement);
+
+#ifdef COAL_COMPUTED_GOTO
+        goto *dispatch[st->op];
+#endif
+
+        switch (st->op)
+        {
+            COAL_CASE(OP_NULL)
+            continue;
+
+            COAL_CASE(OP_CALL)
+            {
+                a = COAL_OPERAND(st->a);
+
+                int fnum_call = (int)*a;
+                if (fnum_call <= 0)
+                    RunError("NULL function");
+
+                /* negative statements are built in functions */
+                if (functions_[fnum_call]->first_statement < 0)
+                    EnterNative(fnum_call, st->b);
+                else
+                    EnterFunction(fnum_call);
+                continue;
+            }
+
+            COAL_CASE(OP_RET)
+            {
+                LeaveFunction();
+
+                // all done?
+                if (exec_.call_depth == exitdepth)
+                {
+                    exec_.instructions += kMaximumRunaway - runaway;
+                    return;
+                }
+
+                continue;
+            }
+
+            COAL_CASE(OP_PARM_NULL)
+            {
+                exec_.stack[exec_.stack_depth + functions_[exec_.func]->locals_end + st->b] = -FLT_MAX;
+                continue;
+            }
+
+            COAL_CASE(OP_PARM_F)
+            {
+                a = COAL_OPERAND(st->a);
+
+                exec_.stack[exec_.stack_depth + functions_[exec_.func]->locals_end + st->b] = *a;
+                continue;
+            }
+
+            COAL_CASE(OP_PARM_V)
+            {
+                a = COAL_OPERAND(st->a);
+                b = &exec_.stack[exec_.stack_depth + functions_[exec_.func]->locals_end + st->b];
+
+                b[0] = a[0];
+                b[1] = a[1];
+                b[2] = a[2];
+                continue;
+            }
+
+            COAL_CASE(OP_IFNOT)
+            {
+                if (!COAL_OPERAND(st->a)[0])
+                    exec_.s = st->b;
+                continue;
+            }
+
+            COAL_CASE(OP_IF)
+            {
+                if (COAL_OPERAND(st->a)[0])
+                    exec_.s = st->b;
+                continue;
+            }
+
+            COAL_CASE(OP_GOTO)
+            exec_.s = st->b;
+            continue;
+
+            COAL_CASE(OP_ERROR)
+            RunError("Assertion failed @ %s:%d\n", COAL_REF_STRING(st->a), st->b);
+
+            COAL_CASE(OP_MOVE_F)
+            COAL_CASE(OP_MOVE_FNC) // pointers
+            COAL_DECODE_ABC();
+            *b = *a;
+            continue;
+
+            COAL_CASE(OP_MOVE_S)
+            COAL_DECODE_ABC();
+            // temp strings must be internalised when assigned
+            // to a global variable.
+            if (*a < 0 && st->b > kReturnOffset * 8)
+                *b = InternaliseString(COAL_REF_STRING((int)*a));
+            else
+                *b = *a;
+            continue;
+
+            COAL_CASE(OP_MOVE_V)
+            COAL_DECODE_ABC();
+            b[0] = a[0];
+            b[1] = a[1];
+            b[2] = a[2];
+            continue;
+
+            COAL_CASE(OP_NOT_F)
+            COAL_CASE(OP_NOT_FNC)
+            COAL_CASE(OP_NOT_S)
+            COAL_DECODE_ABC();
+            *c = !*a;
+            continue;
+
+            COAL_CASE(OP_NOT_V)
+            COAL_DECODE_ABC();
+            *c = !a[0] && !a[1] && !a[2];
+            continue;
+
+            COAL_CASE(OP_INC)
+            COAL_DECODE_ABC();
+            *c = *a + 1;
+            continue;
+
+            COAL_CASE(OP_DEC)
+            COAL_DECODE_ABC();
+            *c = *a - 1;
+            continue;
+
+            COAL_CASE(OP_ADD_F)
+            COAL_DECODE_ABC();
+            *c = *a + *b;
+            continue;
+
+            COAL_CASE(OP_ADD_V)
+            COAL_DECODE_ABC();
+            c[0] = a[0] + b[0];
+            c[1] = a[1] + b[1];
+            c[2] = a[2] + b[2];
+            continue;
+
+            COAL_CASE(OP_ADD_S)
+            COAL_DECODE_ABC();
+            *c = StringConcat(COAL_REF_STRING((int)*a), COAL_REF_STRING((int)*b));
+            // temp strings must be internalised when assigned
+            // to a global variable.
+            if (st->c > kReturnOffset * 8)
+                *c = InternaliseString(COAL_REF_STRING((int)*c));
+            continue;
+
+            COAL_CASE(OP_ADD_SF)
+            COAL_DECODE_ABC();
+            *c = StringConcatFloat(COAL_REF_STRING((int)*a), *b);
+            if (st->c > kReturnOffset * 8)
+                *c = InternaliseString(COAL_REF_STRING((int)*c));
+            continue;
+
+            COAL_CASE(OP_ADD_SV)
+            COAL_DECODE_ABC();
+            *c = StringConcatVector(COAL_REF_STRING((int)*a), b);
+            if (st->c > kReturnOffset * 8)
+                *c = InternaliseString(COAL_REF_STRING((int)*c));
+            continue;
+
+            COAL_CASE(OP_SUB_F)
+            COAL_DECODE_ABC();
+            *c = *a - *b;
+            continue;
+
+            COAL_CASE(OP_SUB_V)
+            COAL_DECODE_ABC();
+            c[0] = a[0] - b[0];
+            c[1] = a[1] - b[1];
+            c[2] = a[2] - b[2];
+            continue;
+
+            COAL_CASE(OP_MUL_F)
+            COAL_DECODE_ABC();
+            *c = *a * *b;
+            continue;
+
+            COAL_CASE(OP_MUL_V)
+            COAL_DECODE_ABC();
+            *c = a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+            continue;
+
+            COAL_CASE(OP_MUL_FV)
+            COAL_DECODE_ABC();
+            c[0] = a[0] * b[0];
+            c[1] = a[0] * b[1];
+            c[2] = a[0] * b[2];
+            continue;
+
+            COAL_CASE(OP_MUL_VF)
+            COAL_DECODE_ABC();
+            c[0] = b[0] * a[0];
+            c[1] = b[0] * a[1];
+            c[2] = b[0] * a[2];
+            continue;
+
+            COAL_CASE(OP_DIV_F)
+            COAL_DECODE_ABC();
+            if (AlmostEquals(*b, 0.0))
+                RunError("Division by zero");
+            *c = *a / *b;
+            continue;
+
+            COAL_CASE(OP_DIV_V)
+            COAL_DECODE_ABC();
+            if (AlmostEquals(*b, 0.0))
+                RunError("Division by zero");
+            c[0] = a[0] / *b;
+            c[1] = a[1] / *b;
+            c[2] = a[2] / *b;
+            continue;
+
+            COAL_CASE(OP_MOD_F)
+            {
+                COAL_DECODE_ABC();
+                if (AlmostEquals(*b, 0.0))
+                    RunError("Division by zero");
+
+                float d = floorf(*a / *b);
+                *c      = *a - d * (*b);
+                continue;
+            }
+
+            COAL_CASE(OP_POWER_F)
+            COAL_DECODE_ABC();
+            *c = powf(*a, *b);
+            continue;
+
+            COAL_CASE(OP_GE)
+            COAL_DECODE_ABC();
+            *c = *a >= *b;
+            continue;
+
+            COAL_CASE(OP_LE)
+            COAL_DECODE_ABC();
+            *c = *a <= *b;
+            continue;
+
+            COAL_CASE(OP_GT)
+            COAL_DECODE_ABC();
+            *c = *a > *b;
+            continue;
+
+            COAL_CASE(OP_LT)
+            COAL_DECODE_ABC();
+            *c = *a < *b;
+            continue;
+
+            COAL_CASE(OP_EQ_F)
+            COAL_CASE(OP_EQ_FNC)
+            COAL_DECODE_ABC();
+            *c = AlmostEquals(*a, *b);
+            continue;
+
+            COAL_CASE(OP_EQ_V)
+            COAL_DECODE_ABC();
+            *c = (AlmostEquals(a[0], b[0])) && (AlmostEquals(a[1], b[1])) && (AlmostEquals(a[2], b[2]));
+            continue;
+
+            COAL_CASE(OP_EQ_S)
+            COAL_DECODE_ABC();
+            *c = (AlmostEquals(*a, *b)) ? 1 : !strcmp(COAL_REF_STRING((int)*a), COAL_REF_STRING((int)*b));
+            continue;
+
+            COAL_CASE(OP_NE_F)
+            COAL_CASE(OP_NE_FNC)
+            COAL_DECODE_ABC();
+            *c = !AlmostEquals(*a, *b);
+            continue;
+
+            COAL_CASE(OP_NE_V)
+            COAL_DECODE_ABC();
+            *c = (!AlmostEquals(a[0], b[0])) || (!AlmostEquals(a[1], b[1])) || (!AlmostEquals(a[2], b[2]));
+            continue;
+
+            COAL_CASE(OP_NE_S)
+            COAL_DECODE_ABC();
+            *c = (AlmostEquals(*a, *b)) ? 0 : !!strcmp(COAL_REF_STRING((int)*a), COAL_REF_STRING((int)*b));
+            continue;
+
+            COAL_CASE(OP_AND)
+            COAL_DECODE_ABC();
+            *c = *a && *b;
+            continue;
+
+            COAL_CASE(OP_OR)
+            COAL_DECODE_ABC();
+            *c = *a || *b;
+            continue;
+
+            COAL_CASE(OP_BITAND)
+            COAL_DECODE_ABC();
+            *c = (int)*a & (int)*b;
+            continue;
+
+            COAL_CASE(OP_BITOR)
+            COAL_DECODE_ABC();
+            *c = (int)*a | (int)*b;
+            continue;
+
+            COAL_FUSED_COMPARE(OPX_LT_IFNOT, *a < *b, false)
+            COAL_FUSED_COMPARE(OPX_LE_IFNOT, *a <= *b, false)
+            COAL_FUSED_COMPARE(OPX_GT_IFNOT, *a > *b, false)
+            COAL_FUSED_COMPARE(OPX_GE_IFNOT, *a >= *b, false)
+            COAL_FUSED_COMPARE(OPX_EQ_F_IFNOT, AlmostEquals(*a, *b), false)
+            COAL_FUSED_COMPARE(OPX_NE_F_IFNOT, !AlmostEquals(*a, *b), false)
+
+            COAL_FUSED_COMPARE(OPX_LT_IF, *a < *b, true)
+            COAL_FUSED_COMPARE(OPX_LE_IF, *a <= *b, true)
+            COAL_FUSED_COMPARE(OPX_GT_IF, *a > *b, true)
+            COAL_FUSED_COMPARE(OPX_GE_IF, *a >= *b, true)
+            COAL_FUSED_COMPARE(OPX_EQ_F_IF, AlmostEquals(*a, *b), true)
+            COAL_FUSED_COMPARE(OPX_NE_F_IF, !AlmostEquals(*a, *b), true)
+
+            COAL_CASE(OPX_PARM_F_CALL)
+            {
+                a = COAL_OPERAND(st->a);
+
+                exec_.stack[exec_.stack_depth + functions_[exec_.func]->locals_end + st->b] = *a;
+
+                if (!--runaway)
+                    RunError("runaway loop error");
+
+                // now the OP_CALL itself
+                st++;
+                exec_.s += sizeof(Statement);
+
+                a = COAL_OPERAND(st->a);
+
+                int fnum_call = (int)*a;
+                if (fnum_call <= 0)
+                    RunError("NULL function");
+
+                if (functions_[fnum_call]->first_statement < 0)
+                    EnterNative(fnum_call, st->b);
+                else
+                    EnterFunction(fnum_call);
+                continue;
+            }
+
+            COAL_CASE(OPX_BAD_OPCODE)
+            default:
+            RunError("Bad opcode %i", COAL_REF_OP(exec_.s - (int)sizeof(Statement))->op);
+        }
+    }
+
+#undef COAL_FUSED_COMPARE
+#undef COAL_DECODE_ABC
+#undef COAL_CASE
+}
+
+void RealVM::DoExecuteTraced(int fnum)
 {
     Function *f = functions_[fnum];
 
@@ -331,8 +908,7 @@ void RealVM::DoExecute(int fnum)
     {
         Statement *st = COAL_REF_OP(exec_.s);
 
-        if (exec_.tracing)
-            PrintStatement(f, exec_.s);
+        PrintStatement(f, exec_.s);
 
         if (!--runaway)
             RunError("runaway loop error");
@@ -372,7 +948,10 @@ void RealVM::DoExecute(int fnum)
 
                 // all done?
                 if (exec_.call_depth == exitdepth)
+                {
+                    exec_.instructions += kMaximumRunaway - runaway;
                     return;
+                }
 
                 continue;
             }
@@ -625,6 +1204,11 @@ int RealVM::Execute(int func_id)
     return 0;
 }
 
+uint64_t RealVM::GetInstructionCount()
+{
+    return exec_.instructions;
+}
+
 //=================================================================
 //  DEBUGGING STUFF
 //=================================================================
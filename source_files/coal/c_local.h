@@ -27,6 +27,8 @@
 
 #include <stdint.h>
 
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "coal.h"
@@ -376,6 +378,8 @@ struct Execution
 
     CallStack call_stack[kMaximumCallStack + 1];
     int       call_depth = 0;
+
+    uint64_t instructions = 0;
 };
 
 class RealVM : public VM
@@ -413,8 +417,12 @@ class RealVM : public VM
     int FindFunction(const char *name);
     int FindVariable(const char *name);
 
+    double *AccessVariable(int var_handle);
+
     int Execute(int func_id);
 
+    uint64_t GetInstructionCount();
+
     double     *AccessParam(int p);
     const char *AccessParamString(int p);
 
@@ -433,9 +441,17 @@ class RealVM : public VM
     std::vector<Function *>                 functions_;
     std::vector<RegisteredNativeFunction *> native_funcs_;
 
+    // function name -> index in functions_ (the last definition wins)
+    std::unordered_map<std::string, int> function_index_;
+
     Compiler  comp_;
     Execution exec_;
 
+    // flat copy of op_mem_ used by the fast interpreter loop, where
+    // common instruction pairs are replaced by fused operations.
+    // Cleared by CompileFile() and rebuilt on the next Execute().
+    std::vector<Statement> threaded_code_;
+
     // c_compile.cc
   private:
     void GLOBGlobals();
@@ -463,7 +479,7 @@ class RealVM : public VM
     Definition *EXPLiteral();
 
     Definition *DeclareDef(Type *type, char *name, Scope *scope);
-    Definition *FindDef(Type *type, char *name, Scope *scope);
+    Definition *FindDef(Type *type, const char *name, Scope *scope);
 
     void        StoreLiteral(int ofs);
     Definition *FindLiteral();
@@ -498,7 +514,9 @@ class RealVM : public VM
 
     // c_execute.cc
   private:
+    void BuildThreadedCode();
     void DoExecute(int func_id);
+    void DoExecuteTraced(int func_id);
 
     void EnterNative(int func, int argc);
     void EnterFunction(int func);
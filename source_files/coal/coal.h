@@ -25,6 +25,8 @@
 
 #pragma once
 
+#include <stdint.h>
+
 namespace coal
 {
 
@@ -75,11 +77,23 @@ class VM
     virtual void SetVectorY(const char *mod_name, const char *var_name, double val)                              = 0;
     virtual void SetVectorZ(const char *mod_name, const char *var_name, double val)                              = 0;
 
+    // Handles: resolve a name once (e.g. after compiling the scripts) and
+    // keep the result, which stays valid for the lifetime of the VM.
+    // FindVariable() takes "module.name" or a global name.  Both return
+    // NOT_FOUND when there is no such function or variable.
     virtual int FindFunction(const char *name) = 0;
     virtual int FindVariable(const char *name) = 0;
 
+    // storage for a float, vector or string variable (strings are held
+    // as string references, so use GetString/SetString for those).
+    // Returns nullptr for NOT_FOUND.
+    virtual double *AccessVariable(int var_handle) = 0;
+
     virtual int Execute(int func_id) = 0;
 
+    // instructions run so far, with each fused pair counting as two
+    virtual uint64_t GetInstructionCount() = 0;
+
     virtual double     *AccessParam(int p)       = 0;
     virtual const char *AccessParamString(int p) = 0;
 
@@ -59,12 +59,9 @@ AnimationDefinition *AnimationDefinitionContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<AnimationDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        AnimationDefinition *anim = *iter;
-        if (DDFCompareName(anim->name_.c_str(), refname) == 0)
-            return anim;
-    }
+    int idx = name_index_.FindFirst(*this, refname);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
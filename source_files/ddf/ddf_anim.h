@@ -81,6 +81,9 @@ class AnimationDefinitionContainer : public std::vector<AnimationDefinition *>
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     AnimationDefinition *Lookup(const char *refname);
 };
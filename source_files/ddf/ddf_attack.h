@@ -24,6 +24,9 @@ class AttackDefinitionContainer : public std::vector<AttackDefinition *>
     AttackDefinitionContainer();
     ~AttackDefinitionContainer();
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     AttackDefinition *Lookup(const char *refname);
 };
@@ -303,12 +303,9 @@ Colormap *ColormapContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<Colormap *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        Colormap *cmap = *iter;
-        if (DDFCompareName(cmap->name_.c_str(), refname) == 0)
-            return cmap;
-    }
+    int idx = name_index_.FindFirst(*this, refname);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
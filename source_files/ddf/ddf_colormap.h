@@ -87,6 +87,9 @@ class ColormapContainer : public std::vector<Colormap *>
     ColormapContainer();
     ~ColormapContainer();
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     Colormap *Lookup(const char *refname);
 };
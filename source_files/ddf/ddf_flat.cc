@@ -209,12 +209,9 @@ FlatDefinition *FlatDefinitionContainer::Find(const char *name)
     if (!name || !name[0])
         return nullptr;
 
-    for (std::vector<FlatDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        FlatDefinition *flt = *iter;
-        if (DDFCompareName(flt->name_.c_str(), name) == 0)
-            return flt;
-    }
+    int idx = name_index_.FindFirst(*this, name);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
@@ -81,6 +81,9 @@ class FlatDefinitionContainer : public std::vector<FlatDefinition *>
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     FlatDefinition *Find(const char *name);
 };
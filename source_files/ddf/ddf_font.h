@@ -101,6 +101,9 @@ class FontDefinitionContainer : public std::vector<FontDefinition *>
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     // Search Functions
     FontDefinition *Lookup(const char *refname);
@@ -813,12 +813,9 @@ GameDefinition *GameDefinitionContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (std::vector<GameDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        GameDefinition *game = *iter;
-        if (DDFCompareName(game->name_.c_str(), refname) == 0)
-            return game;
-    }
+    int idx = name_index_.FindFirst(*this, refname);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
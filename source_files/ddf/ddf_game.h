@@ -212,9 +212,18 @@ class GameDefinitionContainer : public std::vector<GameDefinition *>
     GameDefinitionContainer();
     ~GameDefinitionContainer();
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     // Search Functions
     GameDefinition *Lookup(const char *refname);
+
+    // must be called after renaming an entry which is already in the list
+    void InvalidateNameIndex()
+    {
+        name_index_.Invalidate();
+    }
 };
 
 extern GameDefinitionContainer gamedefs; // -ACB- 2004/06/21 Implemented
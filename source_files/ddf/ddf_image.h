@@ -141,6 +141,8 @@ class ImageDefinitionContainer : public std::vector<ImageDefinition *>
   private:
     void CleanupObject(void *obj);
 
+    DDFNameIndex name_index_;
+
   public:
     // Search Functions
     ImageDefinition *Lookup(const char *refname, ImageNamespace belong);
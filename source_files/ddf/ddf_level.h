@@ -203,6 +203,9 @@ class MapDefinitionContainer : public std::vector<MapDefinition *>
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     MapDefinition *Lookup(const char *name);
 };
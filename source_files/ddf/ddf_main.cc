@@ -20,6 +20,9 @@
 #include <stdarg.h>
 #include <string.h>
 
+#include <algorithm>
+#include <unordered_map>
+
 #include "ddf_anim.h"
 #include "ddf_colormap.h"
 #include "ddf_font.h"
@@ -29,6 +32,7 @@
 #include "ddf_switch.h"
 #include "epi.h"
 #include "epi_filesystem.h"
+#include "epi_md5.h"
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
 #include "p_action.h"
@@ -71,6 +75,21 @@ enum DDFReadCharReturn
 
 #define DDF_DEBUG_READ 0
 
+// what DDFMainReadFile() records in a DDFTokenStream.  Every token is
+// followed by the line number, then by the arguments noted here.
+enum DDFToken
+{
+    kDDFTokenEnd = 0,
+    kDDFTokenClearAll,
+    kDDFTokenNoPatchMenus,
+    kDDFTokenStartEntry,  // name (with any "++" prefix)
+    kDDFTokenParseField,  // index, is_last, field, contents
+    kDDFTokenFinishEntry,
+};
+
+DDFTokenStream *ddf_token_record = nullptr;
+DDFTokenStream *ddf_token_replay = nullptr;
+
 bool strict_errors = false;
 bool lax_errors    = false;
 bool no_warnings   = false;
@@ -687,6 +706,90 @@ static DDFReadCharReturn DDFMainProcessChar(char character, std::string &token,
     return kDDFReadCharReturnNothing;
 }
 
+static void DDFMainRecordToken(DDFToken token)
+{
+    if (ddf_token_record != nullptr)
+    {
+        ddf_token_record->PutInt(token);
+        ddf_token_record->PutInt(cur_ddf_line_num);
+    }
+}
+
+static void DDFMainRecordField(const char *field, const char *contents, int index, bool is_last)
+{
+    if (ddf_token_record != nullptr)
+    {
+        DDFMainRecordToken(kDDFTokenParseField);
+
+        ddf_token_record->PutInt(index);
+        ddf_token_record->PutInt(is_last ? 1 : 0);
+        ddf_token_record->PutString(field);
+        ddf_token_record->PutString(contents);
+    }
+}
+
+//
+// Feed the tokens DDFMainReadFile() recorded for a file back through
+// 'readinfo', in place of reading the text.
+//
+static void DDFMainReplayFile(DDFReadInfo *readinfo)
+{
+    for (;;)
+    {
+        int token = ddf_token_replay->GetInt();
+
+        cur_ddf_line_num = ddf_token_replay->GetInt();
+
+        if (token == kDDFTokenEnd)
+            break;
+
+        switch (token)
+        {
+        case kDDFTokenClearAll:
+            (*readinfo->clear_all)();
+            break;
+
+        case kDDFTokenNoPatchMenus:
+            styledefs.patch_menus_allowed_ = false;
+            break;
+
+        case kDDFTokenStartEntry: {
+            const char *name = ddf_token_replay->GetString();
+
+            cur_ddf_entryname = epi::StringFormat("[%s]", name);
+
+            if (name[0] == '+' && name[1] == '+')
+                (*readinfo->start_entry)(name + 2, true);
+            else
+                (*readinfo->start_entry)(name, false);
+            break;
+        }
+
+        case kDDFTokenParseField: {
+            int  index   = ddf_token_replay->GetInt();
+            bool is_last = ddf_token_replay->GetInt() != 0;
+
+            const char *field    = ddf_token_replay->GetString();
+            const char *contents = ddf_token_replay->GetString();
+
+            (*readinfo->parse_field)(field, contents, index, is_last);
+            break;
+        }
+
+        case kDDFTokenFinishEntry:
+            (*readinfo->finish_entry)();
+            cur_ddf_entryname.clear();
+            break;
+
+        default:
+            FatalError("DDF: bad token %d in cached parse\n", token);
+        }
+    }
+
+    cur_ddf_entryname.clear();
+    cur_ddf_filename.clear();
+}
+
 //
 // DDFMainReadFile
 //
@@ -700,9 +803,6 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
     std::string token;
     std::string current_cmd;
 
-    char *name  = nullptr;
-    char *value = nullptr;
-
     int current_index = 0;
 
 #if (DDF_DEBUG_READ)
@@ -720,13 +820,18 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
     cur_ddf_filename = std::string(readinfo->lumpname);
     cur_ddf_entryname.clear();
 
-    // WISH: don't make this copy, parse directly from the string
-    char *memfile = new char[data.size() + 1];
-    data.copy(memfile, std::string::npos);
-    memfile[data.size()] = 0;
+    // a recorded parse of this same text is being fed back
+    if (ddf_token_replay != nullptr)
+    {
+        DDFMainReplayFile(readinfo);
+        return;
+    }
 
-    char *memfileptr = memfile;
-    int   memsize    = (int)data.size();
+    // parse directly from the caller's string.  Like the old copy, it is
+    // NUL terminated, so peeking one character past the end is safe.
+    const char *memfile    = data.c_str();
+    const char *memfileptr = memfile;
+    int         memsize    = (int)data.size();
 
     // -ACB- 1998/09/12 Copy file to memory: Read until end. Speed optimisation.
     while (memfileptr < &memfile[memsize])
@@ -737,27 +842,25 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
             bool line = false;
 
             memfileptr += 8;
-            name = memfileptr;
+
+            const char *name_start = memfileptr;
 
             while (*memfileptr != ' ' && memfileptr < &memfile[memsize])
                 memfileptr++;
 
-            if (memfileptr < &memfile[memsize])
-            {
-                *memfileptr++ = 0;
-                value         = memfileptr;
-            }
-            else
-            {
-                DDFError("#DEFINE '%s' as what?!\n", name);
-            }
+            std::string name(name_start, memfileptr - name_start);
+
+            if (memfileptr >= &memfile[memsize])
+                DDFError("#DEFINE '%s' as what?!\n", name.c_str());
+
+            memfileptr++;
+
+            const char *value_start = memfileptr;
 
             // FIXME handle comments, stop at "//"
 
             while (memfileptr < &memfile[memsize])
             {
-                if (*memfileptr == '\r')
-                    *memfileptr = ' ';
                 if (*memfileptr == '\\')
                     line = true;
                 if (*memfileptr == '\n' && !line)
@@ -765,10 +868,13 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
                 memfileptr++;
             }
 
+            std::string value(value_start, memfileptr - value_start);
+            std::replace(value.begin(), value.end(), '\r', ' ');
+
             if (*memfileptr == '\n')
                 cur_ddf_line_num++;
 
-            *memfileptr++ = 0;
+            memfileptr++;
 
             DDFMainAddDefine(name, value);
 
@@ -805,7 +911,7 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
             {
             }
 
-            cur_ddf_linedata = std::string(memfileptr, l_len);
+            cur_ddf_linedata.assign(memfileptr, l_len);
 
             // -AJA- 2001/05/21: handle directives (lines beginning with #).
             // This code is more hackitude -- to be fixed when the whole
@@ -816,6 +922,8 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
                 if (!firstgo)
                     DDFError("#CLEARALL cannot be used inside an entry !\n");
 
+                DDFMainRecordToken(kDDFTokenClearAll);
+
                 (*readinfo->clear_all)();
 
                 memfileptr += l_len;
@@ -833,6 +941,8 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
             {
                 if (epi::StringCaseCompareASCII(readinfo->lumpname, "DDFSTYLE") == 0)
                 {
+                    DDFMainRecordToken(kDDFTokenNoPatchMenus);
+
                     styledefs.patch_menus_allowed_ = false;
                 }
                 memfileptr += l_len;
@@ -899,6 +1009,8 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
                 cur_ddf_linedata.clear();
 
                 // finish off previous entry
+                DDFMainRecordToken(kDDFTokenFinishEntry);
+
                 (*readinfo->finish_entry)();
 
                 token.clear();
@@ -912,6 +1024,12 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
         case kDDFReadCharReturnDefinitionStop:
             cur_ddf_entryname = epi::StringFormat("[%s]", token.c_str());
 
+            if (ddf_token_record != nullptr)
+            {
+                DDFMainRecordToken(kDDFTokenStartEntry);
+                ddf_token_record->PutString(token.c_str());
+            }
+
             // -AJA- 2009/07/27: extend an existing entry
             if (token[0] == '+' && token[1] == '+')
                 (*readinfo->start_entry)(token.c_str() + 2, true);
@@ -951,7 +1069,11 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
                 DDFWarnError("Command %s used outside of any entry\n", current_cmd.c_str());
             else
             {
-                (*readinfo->parse_field)(current_cmd.c_str(), DDFMainGetDefine(token.c_str()), current_index, false);
+                const char *contents = DDFMainGetDefine(token.c_str());
+
+                DDFMainRecordField(current_cmd.c_str(), contents, current_index, false);
+
+                (*readinfo->parse_field)(current_cmd.c_str(), contents, current_index, false);
                 current_index++;
             }
 
@@ -968,19 +1090,24 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
             status = kDDFReadStatusReadingData;
             break;
 
-        case kDDFReadCharReturnTerminator:
+        case kDDFReadCharReturnTerminator: {
             if (current_cmd.empty())
                 DDFError("Unexpected semicolon `;'.\n");
 
             if (bracket_level > 0)
                 DDFError("Missing ')' bracket in ddf command.\n");
 
-            (*readinfo->parse_field)(current_cmd.c_str(), DDFMainGetDefine(token.c_str()), current_index, true);
+            const char *contents = DDFMainGetDefine(token.c_str());
+
+            DDFMainRecordField(current_cmd.c_str(), contents, current_index, true);
+
+            (*readinfo->parse_field)(current_cmd.c_str(), contents, current_index, true);
             current_index = 0;
 
             token.clear();
             status = kDDFReadStatusReadingCommand;
             break;
+        }
 
         case kDDFReadCharReturnProperty:
             DDFWarnError("Badly formed command: Unexpected semicolon `;'\n");
@@ -1027,9 +1154,13 @@ void DDFMainReadFile(DDFReadInfo *readinfo, const std::string &data)
 
     // if firstgo is true, nothing was defined
     if (!firstgo)
+    {
+        DDFMainRecordToken(kDDFTokenFinishEntry);
+
         (*readinfo->finish_entry)();
+    }
 
-    delete[] memfile;
+    DDFMainRecordToken(kDDFTokenEnd);
 
     cur_ddf_entryname.clear();
     cur_ddf_filename.clear();
@@ -1101,14 +1232,28 @@ void DDFMainGetString(const char *info, void *storage)
 }
 
 //
-// DDFMainParseField
+// Field name index for a command list.
 //
-// Check if the command exists, and call the parser function if it
-// does (and return true), otherwise return false.
+// Plain command names are hashed with DDFHashName() (matching the way
+// DDFCompareName() compares them), each hash listing the positions in
+// ascending order.  Sub-lists need a prefix match, so they are kept
+// apart and checked in order.  Built the first time a list is used.
 //
-bool DDFMainParseField(const DDFCommandList *commands, const char *field, const char *contents, uint8_t *obj_base)
+struct DDFCommandIndex
 {
-    EPI_ASSERT(obj_base);
+    std::unordered_map<uint32_t, std::vector<int>> names;
+    std::vector<int>                               sub_lists;
+};
+
+static std::unordered_map<const DDFCommandList *, DDFCommandIndex> command_indexes;
+
+static const DDFCommandIndex &DDFMainCommandIndex(const DDFCommandList *commands)
+{
+    std::unordered_map<const DDFCommandList *, DDFCommandIndex>::iterator iter = command_indexes.find(commands);
+    if (iter != command_indexes.end())
+        return iter->second;
+
+    DDFCommandIndex &index = command_indexes[commands];
 
     for (int i = 0; commands[i].name; i++)
     {
@@ -1117,36 +1262,81 @@ bool DDFMainParseField(const DDFCommandList *commands, const char *field, const
         if (name[0] == '!')
             name++;
 
-        // handle subfields
         if (name[0] == '*')
+            index.sub_lists.push_back(i);
+        else
+            index.names[DDFHashName(name)].push_back(i);
+    }
+
+    return index;
+}
+
+//
+// DDFMainParseField
+//
+// Check if the command exists, and call the parser function if it
+// does (and return true), otherwise return false.
+//
+bool DDFMainParseField(const DDFCommandList *commands, const char *field, const char *contents, uint8_t *obj_base)
+{
+    EPI_ASSERT(obj_base);
+
+    const DDFCommandIndex &index = DDFMainCommandIndex(commands);
+
+    // the earliest matching entry wins, as with a scan of the list
+    int found = -1;
+
+    std::unordered_map<uint32_t, std::vector<int>>::const_iterator bucket = index.names.find(DDFHashName(field));
+
+    if (bucket != index.names.end())
+    {
+        for (int i : bucket->second)
         {
-            name++;
+            const char *name = commands[i].name;
 
-            int len = strlen(name);
-            EPI_ASSERT(len > 0);
+            if (name[0] == '!')
+                name++;
 
-            if (strncmp(field, name, len) == 0 && field[len] == '.' && epi::IsAlphanumericASCII(field[len + 1]))
+            if (DDFCompareName(field, name) == 0)
             {
-                // recursively parse the sub-field
-                return DDFMainParseField(commands[i].sub_comms, field + len + 1, contents,
-                                         obj_base + commands[i].offset);
+                found = i;
+                break;
             }
-
-            continue;
         }
+    }
 
-        if (DDFCompareName(field, name) != 0)
-            continue;
+    // handle subfields
+    for (int i : index.sub_lists)
+    {
+        if (found >= 0 && i > found)
+            break;
 
-        // found it, so call parse routine
-        EPI_ASSERT(commands[i].parse_command);
+        const char *name = commands[i].name;
+
+        if (name[0] == '!')
+            name++;
 
-        (*commands[i].parse_command)(contents, obj_base + commands[i].offset);
+        name++; // skip the '*'
 
-        return true;
+        int len = strlen(name);
+        EPI_ASSERT(len > 0);
+
+        if (strncmp(field, name, len) == 0 && field[len] == '.' && epi::IsAlphanumericASCII(field[len + 1]))
+        {
+            // recursively parse the sub-field
+            return DDFMainParseField(commands[i].sub_comms, field + len + 1, contents, obj_base + commands[i].offset);
+        }
     }
 
-    return false;
+    if (found < 0)
+        return false;
+
+    // found it, so call parse routine
+    EPI_ASSERT(commands[found].parse_command);
+
+    (*commands[found].parse_command)(contents, obj_base + commands[found].offset);
+
+    return true;
 }
 
 void DDFMainGetLumpName(const char *info, void *storage)
@@ -2067,6 +2257,8 @@ WeaknessDefinition &WeaknessDefinition::operator=(const WeaknessDefinition &rhs)
 
 static std::vector<DDFFile> unread_ddf;
 
+bool ddf_keep_text = false;
+
 struct ddf_reader_t
 {
     DDFType     type;
@@ -2193,6 +2385,14 @@ static void DDFParseUnreadFile(size_t d)
                 strict_errors = false;
             }
 
+            if (ddf_token_record != nullptr)
+                ddf_token_record->PutInt(it.type);
+
+            // the cache is keyed by the input, so it cannot be out of step
+            // unless the file is damaged
+            if (ddf_token_replay != nullptr && ddf_token_replay->GetInt() != it.type)
+                FatalError("DDF: cached parse does not match %s\n", it.source.c_str());
+
             if (it.type == kDDFTypeRadScript)
             {
                 ReadRADScript(it.data, it.source);
@@ -2205,21 +2405,215 @@ static void DDFParseUnreadFile(size_t d)
             }
 
             // can free the memory now
-            it.data.clear();
+            if (!ddf_keep_text)
+                it.data.clear();
 
             if (converted_ddf) strict_errors = old_strict;
         }
     }
 }
 
-void DDFParseEverything()
+std::string DDFUnreadHash()
 {
+    std::string key;
+
+    for (const DDFFile &it : unread_ddf)
+    {
+        epi::MD5Hash md5((const uint8_t *)it.data.data(), (unsigned int)it.data.size());
+
+        key += epi::StringFormat("%d:%s\n", (int)it.type, md5.ToString().c_str());
+    }
+
+    epi::MD5Hash key_md5((const uint8_t *)key.data(), (unsigned int)key.size());
+
+    return key_md5.ToString();
+}
+
+//
+// Token cache files are a header followed by the token stream.  The
+// MD5 of the stream is checked on load, since a damaged stream would
+// only be noticed halfway through parsing.
+//
+
+// bump this whenever the recorded tokens change meaning
+static constexpr uint32_t kDDFTokenCacheVersion = 1;
+
+static constexpr char kDDFTokenCacheMagic[4] = {'E', 'D', 'T', 'C'};
+
+struct DDFTokenCacheHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t size;     // of the token stream
+    char     md5[32];  // of the token stream, in hex
+};
+
+static bool DDFLoadTokens(const std::string &filename, DDFTokenStream &tokens)
+{
+    FILE *fp = epi::FileOpenRaw(filename, epi::kFileAccessRead | epi::kFileAccessBinary);
+
+    if (!fp)
+        return false;
+
+    DDFTokenCacheHeader header;
+
+    bool ok = (fread(&header, sizeof(header), 1, fp) == 1) && memcmp(header.magic, kDDFTokenCacheMagic, 4) == 0 &&
+              header.version == kDDFTokenCacheVersion;
+
+    if (ok)
+    {
+        tokens.data_.resize(header.size);
+
+        ok = (header.size == 0 || fread(&tokens.data_[0], 1, header.size, fp) == header.size);
+    }
+
+    fclose(fp);
+
+    if (ok)
+    {
+        epi::MD5Hash md5((const uint8_t *)tokens.data_.data(), (unsigned int)tokens.data_.size());
+
+        ok = (memcmp(header.md5, md5.ToString().c_str(), 32) == 0);
+    }
+
+    if (!ok)
+        tokens.data_.clear();
+
+    return ok;
+}
+
+static void DDFSaveTokens(const std::string &filename, const DDFTokenStream &tokens)
+{
+    std::string temp_name = filename + ".tmp";
+
+    FILE *fp = epi::FileOpenRaw(temp_name, epi::kFileAccessWrite | epi::kFileAccessBinary);
+
+    if (!fp)
+        return;
+
+    DDFTokenCacheHeader header;
+
+    EPI_CLEAR_MEMORY(&header, DDFTokenCacheHeader, 1);
+
+    memcpy(header.magic, kDDFTokenCacheMagic, 4);
+
+    header.version = kDDFTokenCacheVersion;
+    header.size    = (uint32_t)tokens.data_.size();
+
+    epi::MD5Hash md5((const uint8_t *)tokens.data_.data(), (unsigned int)tokens.data_.size());
+
+    memcpy(header.md5, md5.ToString().c_str(), 32);
+
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1) &&
+              (header.size == 0 || fwrite(tokens.data_.data(), 1, header.size, fp) == header.size);
+
+    if (fclose(fp) != 0)
+        ok = false;
+
+    // written aside and renamed, so a truncated entry is never seen
+    if (!ok || !epi::FileRename(temp_name, filename))
+        epi::FileDelete(temp_name);
+}
+
+void DDFParseEverything(const std::string &cache_file)
+{
+    DDFTokenStream tokens;
+
+    if (!cache_file.empty())
+    {
+        if (DDFLoadTokens(cache_file, tokens))
+        {
+            LogPrint("DDF: using cached parse %s\n", cache_file.c_str());
+            ddf_token_replay = &tokens;
+        }
+        else
+        {
+            ddf_token_record = &tokens;
+        }
+    }
+
     // -AJA- Since DDF files have dependencies between them, it makes most
     //       sense to load all lumps of a certain type together, for example
     //       all DDFSFX lumps before all the DDFTHING lumps.
 
     for (size_t d = 0; d < kTotalDDFTypes; d++)
         DDFParseUnreadFile(d);
+
+    if (ddf_token_record != nullptr)
+        DDFSaveTokens(cache_file, tokens);
+
+    ddf_token_record = nullptr;
+    ddf_token_replay = nullptr;
+}
+
+size_t DDFReparseText()
+{
+    size_t total = 0;
+
+    bool old_strict = strict_errors;
+
+    // converted DeHackEd is parsed leniently, so the rest may as well be
+    strict_errors = false;
+
+    for (size_t d = 0; d < kTotalDDFTypes; d++)
+    {
+        if (ddf_readers[d].func == nullptr)
+            continue;
+
+        for (const DDFFile &it : unread_ddf)
+        {
+            if (it.type == ddf_readers[d].type)
+            {
+                (*ddf_readers[d].func)(it.data);
+                total += it.data.size();
+            }
+        }
+    }
+
+    strict_errors = old_strict;
+
+    return total;
+}
+
+void DDFTokenStream::PutInt(int value)
+{
+    data_.append((const char *)&value, sizeof(value));
+}
+
+void DDFTokenStream::PutString(const char *str)
+{
+    int len = (int)strlen(str);
+
+    PutInt(len);
+
+    // keep the terminator, so GetString() can point into the stream
+    data_.append(str, len + 1);
+}
+
+int DDFTokenStream::GetInt()
+{
+    int value;
+
+    if (pos_ + sizeof(value) > data_.size())
+        FatalError("DDF: cached parse is truncated\n");
+
+    memcpy(&value, data_.data() + pos_, sizeof(value));
+    pos_ += sizeof(value);
+
+    return value;
+}
+
+const char *DDFTokenStream::GetString()
+{
+    int len = GetInt();
+
+    if (len < 0 || pos_ + len + 1 > data_.size())
+        FatalError("DDF: cached parse is truncated\n");
+
+    const char *str = data_.c_str() + pos_;
+    pos_ += len + 1;
+
+    return str;
 }
 
 static char ename_buffer[256];
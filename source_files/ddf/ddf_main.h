@@ -161,7 +161,46 @@ DDFType DDFFilenameToType(const std::string &path);
 
 void DDFAddFile(DDFType type, std::string &data, const std::string &source);
 void DDFAddCollection(std::vector<DDFFile> &col, const std::string &source);
-void DDFParseEverything();
+
+// MD5 (in hex) of the types and contents of all DDF/RTS input added so
+// far, in the order it was added.
+std::string DDFUnreadHash();
+
+// When 'cache_file' is not empty, the parse is recorded there as a
+// token stream, or replayed from it when it exists, which skips
+// reading the text.  Its name must identify the input (see above).
+void DDFParseEverything(const std::string &cache_file = "");
+
+// For -benchmark ddf: with ddf_keep_text set, DDFParseEverything() keeps
+// the text it has parsed, and DDFReparseText() parses all of the DDF
+// (not RTS) again, in the same order.  Returns the number of bytes.
+extern bool ddf_keep_text;
+
+size_t DDFReparseText();
+
+//
+// What the DDF and RTS text parsers produce -- entries, fields and
+// script lines -- recorded in order.  DDFParseEverything() sets one of
+// the pointers below while it records or replays a parse.
+//
+class DDFTokenStream
+{
+  public:
+    std::string data_;
+    size_t      pos_ = 0;
+
+  public:
+    void PutInt(int value);
+    void PutString(const char *str);
+
+    int GetInt();
+
+    // the result stays valid as long as the stream does
+    const char *GetString();
+};
+
+extern DDFTokenStream *ddf_token_record;
+extern DDFTokenStream *ddf_token_replay;
 
 void DDFDumpFile(const std::string &data);
 void DDFDumpCollection(const std::vector<DDFFile> &col);
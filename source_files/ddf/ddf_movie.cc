@@ -240,11 +240,9 @@ MovieDefinition *MovieDefinitionContainer::Lookup(const char *refname)
     if (!refname || !refname[0])
         return nullptr;
 
-    for (MovieDefinition *g : moviedefs)
-    {
-        if (DDFCompareName(g->name_.c_str(), refname) == 0)
-            return g;
-    }
+    int idx = name_index_.FindFirst(*this, refname);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
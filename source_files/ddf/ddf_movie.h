@@ -95,6 +95,9 @@ class MovieDefinitionContainer : public std::vector<MovieDefinition *>
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     // Search Functions
     MovieDefinition *Lookup(const char *refname);
@@ -358,13 +358,9 @@ SoundEffect *SoundEffectDefinitionContainer::GetEffect(const char *name, bool er
 //
 SoundEffectDefinition *SoundEffectDefinitionContainer::Lookup(const char *name)
 {
-    for (std::vector<SoundEffectDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        SoundEffectDefinition *s = *iter;
-
-        if (DDFCompareName(s->name_.c_str(), name) == 0)
-            return s;
-    }
+    int idx = name_index_.FindFirst(*this, name);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
@@ -120,6 +120,9 @@ class SoundEffectDefinitionContainer : public std::vector<SoundEffectDefinition
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     // Lookup functions
     SoundEffect           *GetEffect(const char *name, bool error = true);
@@ -186,6 +186,9 @@ class StyleDefinition
 // Our styledefs container
 class StyleDefinitionContainer : public std::vector<StyleDefinition *>
 {
+  private:
+    DDFNameIndex name_index_;
+
   public:
     StyleDefinitionContainer()
     {
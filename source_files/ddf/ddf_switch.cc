@@ -208,12 +208,9 @@ void SwitchDefinition::Default()
 //
 SwitchDefinition *SwitchDefinitionContainer::Find(const char *name)
 {
-    for (std::vector<SwitchDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        SwitchDefinition *sw = *iter;
-        if (DDFCompareName(sw->name_.c_str(), name) == 0)
-            return sw;
-    }
+    int idx = name_index_.FindFirst(*this, name);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
@@ -80,6 +80,9 @@ class SwitchDefinitionContainer : public std::vector<SwitchDefinition *>
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     SwitchDefinition *Find(const char *name);
 };
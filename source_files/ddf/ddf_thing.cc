@@ -585,6 +585,28 @@ int DDFCompareName(const char *A, const char *B)
     }
 }
 
+//
+// DDFHashName
+//
+// Hash a name so that any two names which DDFCompareName() considers
+// equal get the same value (FNV-1a over the upper-cased characters,
+// skipping spaces and underscores).
+//
+uint32_t DDFHashName(const char *name)
+{
+    uint32_t result = 0x811c9dc5;
+
+    for (; *name; name++)
+    {
+        if (*name == ' ' || *name == '_')
+            continue;
+
+        result = (result ^ (uint8_t)epi::ToUpperASCII(*name)) * 16777619;
+    }
+
+    return result;
+}
+
 //
 //  DDF PARSE ROUTINES
 //
@@ -2832,28 +2854,12 @@ MapObjectDefinitionContainer::~MapObjectDefinitionContainer()
 
 int MapObjectDefinitionContainer::FindFirst(const char *name, size_t startpos)
 {
-    for (; startpos < size(); startpos++)
-    {
-        MapObjectDefinition *m = at(startpos);
-        if (DDFCompareName(m->name_.c_str(), name) == 0)
-            return startpos;
-    }
-
-    return -1;
+    return name_index_.FindFirst(*this, name, startpos);
 }
 
 int MapObjectDefinitionContainer::FindLast(const char *name)
 {
-    int startpos = (int)size() - 1;
-
-    for (; startpos >= 0; startpos--)
-    {
-        MapObjectDefinition *m = at(startpos);
-        if (DDFCompareName(m->name_.c_str(), name) == 0)
-            return startpos;
-    }
-
-    return -1;
+    return name_index_.FindLast(*this, name);
 }
 
 bool MapObjectDefinitionContainer::MoveToEnd(int idx)
@@ -2875,6 +2881,8 @@ bool MapObjectDefinitionContainer::MoveToEnd(int idx)
 
     push_back(m);
 
+    name_index_.MoveToEnd(*this, idx);
+
     return true;
 }
 
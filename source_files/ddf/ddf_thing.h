@@ -943,6 +943,8 @@ class MapObjectDefinitionContainer : public std::vector<MapObjectDefinition *>
   private:
     MapObjectDefinition *lookup_cache_[kLookupCacheSize];
 
+    DDFNameIndex name_index_;
+
   public:
     // List Management
     bool MoveToEnd(int idx);
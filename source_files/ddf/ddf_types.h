@@ -25,7 +25,9 @@
 
 #pragma once
 
+#include <algorithm>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include "epi.h"
@@ -38,6 +40,144 @@ class WeaponDefinition;
 
 constexpr uint8_t kLookupCacheSize = 211; // Why this number? - Dasho
 
+int      DDFCompareName(const char *A, const char *B);
+uint32_t DDFHashName(const char *name);
+
+//
+// Name index for the definition containers.
+//
+// Maps a hash of each definition's name (computed the same way that
+// DDFCompareName() compares, i.e. ignoring case, spaces and underscores)
+// to the positions in the container which have that name, in ascending
+// order.  Candidates are always confirmed with DDFCompareName(), so hash
+// collisions are harmless, and FindFirst/FindLast give exactly the same
+// answer as a linear scan from the front or the back.
+//
+// New entries appended with push_back() are picked up on the next
+// lookup.  If the last entry is not the one seen last time (e.g. after
+// erase() or clear()) the whole index is rebuilt, but owners which
+// rename or reorder entries should tell the index about it.
+//
+class DDFNameIndex
+{
+  private:
+    std::unordered_map<uint32_t, std::vector<int>> buckets_;
+
+    size_t      indexed_ = 0;
+    const void *tail_    = nullptr;
+
+  public:
+    void Invalidate()
+    {
+        buckets_.clear();
+        indexed_ = 0;
+        tail_    = nullptr;
+    }
+
+    // the entry at `idx' has just been moved to the end of `defs'
+    template <class T> void MoveToEnd(const std::vector<T *> &defs, size_t idx)
+    {
+        if (idx + 1 >= defs.size())
+            return;
+
+        // the previous last entry must now be the second last one
+        if (indexed_ != defs.size() || defs[indexed_ - 2] != tail_)
+        {
+            Invalidate();
+            return;
+        }
+
+        for (std::pair<const uint32_t, std::vector<int>> &bucket : buckets_)
+        {
+            std::vector<int>::iterator moved = bucket.second.end();
+
+            for (std::vector<int>::iterator iter = bucket.second.begin(); iter != bucket.second.end(); iter++)
+            {
+                if ((size_t)*iter == idx)
+                {
+                    *iter = (int)defs.size() - 1;
+                    moved = iter;
+                }
+                else if ((size_t)*iter > idx)
+                    *iter -= 1;
+            }
+
+            if (moved != bucket.second.end())
+                std::rotate(moved, moved + 1, bucket.second.end());
+        }
+
+        tail_ = defs.back();
+    }
+
+    template <class T> int FindFirst(const std::vector<T *> &defs, const char *name, size_t startpos = 0)
+    {
+        const std::vector<int> *bucket = Bucket(defs, name);
+        if (!bucket)
+            return -1;
+
+        for (int idx : *bucket)
+        {
+            if ((size_t)idx >= startpos && DDFCompareName(defs[idx]->name_.c_str(), name) == 0)
+                return idx;
+        }
+
+        return -1;
+    }
+
+    template <class T> int FindLast(const std::vector<T *> &defs, const char *name)
+    {
+        const std::vector<int> *bucket = Bucket(defs, name);
+        if (!bucket)
+            return -1;
+
+        for (std::vector<int>::const_reverse_iterator iter = bucket->rbegin(); iter != bucket->rend(); iter++)
+        {
+            if (DDFCompareName(defs[*iter]->name_.c_str(), name) == 0)
+                return *iter;
+        }
+
+        return -1;
+    }
+
+    // like FindFirst(), but the entry must also satisfy `match'
+    template <class T, class Pred> int FindFirstMatching(const std::vector<T *> &defs, const char *name, Pred match)
+    {
+        const std::vector<int> *bucket = Bucket(defs, name);
+        if (!bucket)
+            return -1;
+
+        for (int idx : *bucket)
+        {
+            if (DDFCompareName(defs[idx]->name_.c_str(), name) == 0 && match(defs[idx]))
+                return idx;
+        }
+
+        return -1;
+    }
+
+  private:
+    template <class T> const std::vector<int> *Bucket(const std::vector<T *> &defs, const char *name)
+    {
+        if (!name)
+            return nullptr;
+
+        if (defs.size() < indexed_ || (indexed_ > 0 && defs[indexed_ - 1] != tail_))
+            Invalidate();
+
+        for (; indexed_ < defs.size(); indexed_++)
+            buckets_[DDFHashName(defs[indexed_]->name_.c_str())].push_back((int)indexed_);
+
+        if (indexed_ > 0)
+            tail_ = defs[indexed_ - 1];
+
+        std::unordered_map<uint32_t, std::vector<int>>::const_iterator iter = buckets_.find(DDFHashName(name));
+        if (iter == buckets_.end())
+            return nullptr;
+
+        return &iter->second;
+    }
+};
+
 class MobjStringReference
 {
   public:
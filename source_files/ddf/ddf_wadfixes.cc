@@ -169,12 +169,9 @@ void WadFixDefinition::Default()
 //
 WadFixDefinition *WadFixDefinitionContainer::Find(const char *name)
 {
-    for (std::vector<WadFixDefinition *>::iterator iter = begin(), iter_end = end(); iter != iter_end; iter++)
-    {
-        WadFixDefinition *fl = *iter;
-        if (DDFCompareName(fl->name_.c_str(), name) == 0)
-            return fl;
-    }
+    int idx = name_index_.FindFirst(*this, name);
+    if (idx >= 0)
+        return (*this)[idx];
 
     return nullptr;
 }
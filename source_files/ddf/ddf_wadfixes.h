@@ -67,6 +67,9 @@ class WadFixDefinitionContainer : public std::vector<WadFixDefinition *>
         }
     }
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     WadFixDefinition *Find(const char *name);
 };
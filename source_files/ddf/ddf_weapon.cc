@@ -1227,14 +1227,7 @@ WeaponDefinitionContainer::~WeaponDefinitionContainer()
 //
 int WeaponDefinitionContainer::FindFirst(const char *name, size_t startpos)
 {
-    for (; startpos < size(); startpos++)
-    {
-        WeaponDefinition *w = at(startpos);
-        if (DDFCompareName(w->name_.c_str(), name) == 0)
-            return startpos;
-    }
-
-    return -1;
+    return name_index_.FindFirst(*this, name, startpos);
 }
 
 //
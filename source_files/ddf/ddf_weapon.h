@@ -35,6 +35,9 @@ class WeaponDefinitionContainer : public std::vector<WeaponDefinition *>
     WeaponDefinitionContainer();
     ~WeaponDefinitionContainer();
 
+  private:
+    DDFNameIndex name_index_;
+
   public:
     // Search Functions
     int               FindFirst(const char *name, size_t startpos = 0);
@@ -203,6 +203,62 @@ static size_t              automap_line_position = 0;
 // door thickness is at that tic)
 static std::vector<AutomapLine *> map_line_pointers[4];
 
+//
+// Cached wall classification.
+//
+// Each line's colour and draw style only depend on its flags, special and
+// the heights of the sectors either side of it, so the result is kept
+// between frames and only recomputed for lines which the playsim or the
+// renderer has reported through AutomapLineChanged/AutomapSectorChanged
+// (newly mapped, door/lift moved, special consumed, etc).
+// The world-space line batches built from the cache are then transformed
+// to the screen with a single affine transform each frame, so panning,
+// zooming and rotating never touch the classification.
+//
+enum AutomapWallKind
+{
+    kAutomapWallHidden = 0,
+    kAutomapWallNormal, // 1.5f
+    kAutomapWallDoor    // 3.5f or pulsing
+};
+
+struct AutomapWallCache
+{
+    AutomapWallKind kind;
+    RGBAColor       color;
+    int             key_type; // for automap_keydoor_text, 0 if none
+
+    // queued in changed_walls, waiting to be re-classified
+    bool changed;
+};
+
+struct AutomapCachedLine
+{
+    HMM_Vec4  points; // world coordinates
+    RGBAColor color;
+    int       key_type;
+};
+
+// World-to-frame affine transform
+struct AutomapTransform
+{
+    float xx, xy, tx;
+    float yx, yy, ty;
+};
+
+static std::vector<AutomapWallCache>  wall_cache;
+static std::vector<int>               changed_walls;
+static std::vector<AutomapCachedLine> wall_batches[2]; // normal, door
+static bool                           wall_batches_dirty = true;
+
+// show_walls / allmap state the cache was built with, -1 = invalid
+static int wall_cache_mode = -1;
+
+static void InvalidateWallCache(void)
+{
+    wall_cache_mode = -1;
+}
+
 static AutomapLine *GetMapLine()
 {
     if (automap_line_position == automap_lines.size())
@@ -354,6 +410,10 @@ void AutomapInitLevel(void)
 
     FindMinMaxBoundaries();
 
+    wall_cache.clear();
+    changed_walls.clear();
+    InvalidateWallCache();
+
     // Initial reservation if necessary
     if (map_line_pointers[0].capacity() < kDefaultAutomapLines)
     {
@@ -599,6 +659,25 @@ static inline void Rotate(float &x, float &y, BAMAngle a)
     y = new_y;
 }
 
+//
+// Pivot point and angle used when the map is rotated.
+//
+static void GetRotationPivot(float &px, float &py, BAMAngle &ang)
+{
+    if (!console_active && !paused && !menu_active)
+    {
+        px  = frame_lerped_x;
+        py  = frame_lerped_y;
+        ang = kBAMAngle90 - frame_lerped_ang;
+    }
+    else
+    {
+        px  = frame_focus->x;
+        py  = frame_focus->y;
+        ang = kBAMAngle90 - frame_focus->angle_;
+    }
+}
+
 static void GetRotatedCoords(float sx, float sy, float &dx, float &dy)
 {
     dx = sx;
@@ -606,26 +685,18 @@ static void GetRotatedCoords(float sx, float sy, float &dx, float &dy)
 
     if (rotate_map)
     {
-        if (!console_active && !paused && !menu_active)
-        {
-            dx -= frame_lerped_x;
-            dy -= frame_lerped_y;
+        float    px, py;
+        BAMAngle ang;
 
-            Rotate(dx, dy, kBAMAngle90 - frame_lerped_ang);
+        GetRotationPivot(px, py, ang);
 
-            dx += frame_lerped_x;
-            dy += frame_lerped_y;
-        }
-        else
-        {
-            dx -= frame_focus->x;
-            dy -= frame_focus->y;
+        dx -= px;
+        dy -= py;
 
-            Rotate(dx, dy, kBAMAngle90 - frame_focus->angle_);
+        Rotate(dx, dy, ang);
 
-            dx += frame_focus->x;
-            dy += frame_focus->y;
-        }
+        dx += px;
+        dy += py;
     }
 }
 
@@ -668,26 +739,6 @@ static void DrawMLine(AutomapLine *ml, bool thick = true)
         map_line_pointers[0].push_back(ml); // 1.0f
 }
 
-// Lobo 2022: keyed doors automap colouring
-static void DrawMLineDoor(AutomapLine *ml)
-{
-    HMM_Vec4 *points = &ml->points;
-
-    points->X = HUDToRealCoordinatesX(MapToFrameCoordinatesX(points->X, 0)) + map_dx;
-    points->Y = HUDToRealCoordinatesY(MapToFrameCoordinatesY(points->Y, 0)) + map_dy;
-
-    points->Z = HUDToRealCoordinatesX(MapToFrameCoordinatesX(points->Z, 0)) + map_dx;
-    points->W = HUDToRealCoordinatesY(MapToFrameCoordinatesY(points->W, 0)) + map_dy;
-
-    epi::SetRGBAAlpha(ml->color, map_alpha);
-
-    // Lobo 2023: Make keyed doors pulse
-    if (automap_keydoor_blink)
-        map_line_pointers[3].push_back(ml); // variable pulse width
-    else
-        map_line_pointers[2].push_back(ml); // 3.5f
-}
-
 static HMM_Vec4 player_dagger[] = {
     {{{{{-0.75f, 0.0f, 0.0f}}}, 0.0f}},                                              // center line
 
@@ -967,181 +1018,295 @@ static bool CheckSimiliarRegions(Sector *front, Sector *back)
 }
 
 
-//
-// Determines visible lines, draws them.
-//
-static void AddWall(const Line *line)
+void AutomapLineChanged(Line *ld)
 {
-    EPI_ASSERT(line);
+    int index = (int)(ld - level_lines);
+
+    // lines are all classified when the cache is (re)built
+    if (index < 0 || index >= (int)wall_cache.size() || wall_cache[index].changed)
+        return;
+
+    wall_cache[index].changed = true;
+    changed_walls.push_back(index);
+}
+
+void AutomapSectorChanged(Sector *sec)
+{
+    for (int i = 0; i < sec->line_count; i++)
+        AutomapLineChanged(sec->lines[i]);
+}
+
+static void ClassifyWall(const Line *line, AutomapWallCache &wc, bool allmap)
+{
+    Sector *front = line->front_sector;
+    Sector *back  = line->back_sector;
+
+    wc.changed  = false;
+    wc.kind     = kAutomapWallHidden;
+    wc.key_type = 0;
 
     if ((line->flags & kLineFlagMapped) || show_walls)
     {
         if ((line->flags & kLineFlagDontDraw) && !show_walls)
             return;
 
-        AutomapLine *l = GetMapLine();
-        GetRotatedCoords(line->vertex_1->X, line->vertex_1->Y, l->points.X, l->points.Y);
-        GetRotatedCoords(line->vertex_2->X, line->vertex_2->Y, l->points.Z, l->points.W);
-
-        // clip to map frame
-        float x1 = MapToFrameCoordinatesX(l->points.X, map_center_x);
-        float x2 = MapToFrameCoordinatesX(l->points.Z, map_center_x);
-        float y1 = MapToFrameCoordinatesY(l->points.Y, map_center_y);
-        float y2 = MapToFrameCoordinatesY(l->points.W, map_center_y);
-        if ((x1 < frame_x && x2 < frame_x) || (x1 > frame_x + frame_width && x2 > frame_x + frame_width) ||
-            (y1 < frame_y && y2 < frame_y) || (y1 > frame_y + frame_height && y2 > frame_y + frame_height))
-        {
-            automap_line_position--;
-            return;
-        }
-
-        Sector *front = line->front_sector;
-        Sector *back  = line->back_sector;
+        wc.kind = kAutomapWallNormal;
 
         if (!front || !back)
         {
-            l->color = am_colors[kAutomapColorWall];
-            DrawMLine(l);
+            wc.color = am_colors[kAutomapColorWall];
+            return;
         }
-        else
+
+        // Lobo 2022: give keyed doors the colour of the required key
+        if (line->special && line->special->keys_)
         {
-            // Lobo 2022: give keyed doors the colour of the required key
-            if (line->special)
-            {
-                if (line->special->keys_)
-                {
-                    float midx = MapToFrameCoordinatesX((l->points.X + l->points.Z) / 2, map_center_x);
-                    float midy = MapToFrameCoordinatesY((l->points.Y + l->points.W) / 2, map_center_y);
-
-                    if (line->special->keys_ & kDoorKeyStrictlyAllKeys)
-                    {
-                        l->color = kRGBAPurple;
-                        DrawMLineDoor(l); // purple
-                        if (automap_keydoor_text.d_ > 0)
-                            automap_keys.push_back({midx, midy, (int)kDoorKeyStrictlyAllKeys});
-                    }
-                    else if (line->special->keys_ == (kDoorKeyRedCard | kDoorKeyRedSkull | kDoorKeyBlueCard | kDoorKeyBlueSkull | kDoorKeyYellowCard
-                                     | kDoorKeyYellowSkull))
-                    {
-                        l->color = kRGBAFuchsia;
-                        DrawMLineDoor(l); // orange
-                        GetKeyNumber(line->special->keys_);
-                        if (automap_keydoor_text.d_ > 0)
-                            automap_keys.push_back(
-                                {midx, midy,
-                                 (int)(line->special->keys_)});
-                    }
-                    else if (line->special->keys_ & (kDoorKeyBlueSkull | kDoorKeyBlueCard))
-                    {
-                        l->color = kRGBABlue;
-                        DrawMLineDoor(l); // blue
-                        GetKeyNumber(line->special->keys_);
-                        if (automap_keydoor_text.d_ > 0)
-                            automap_keys.push_back(
-                                {midx, midy,
-                                 (int)(line->special->keys_)});
-                    }
-                    else if (line->special->keys_ & (kDoorKeyYellowSkull | kDoorKeyYellowCard))
-                    {
-                        l->color = kRGBAYellow;
-                        DrawMLineDoor(l); // yellow
-                        if (automap_keydoor_text.d_ > 0)
-                            automap_keys.push_back(
-                                {midx, midy,
-                                 (int)(line->special->keys_)});
-                    }
-                    else if (line->special->keys_ & (kDoorKeyRedSkull | kDoorKeyRedCard))
-                    {
-                        l->color = kRGBARed;
-                        DrawMLineDoor(l); // red
-                        if (automap_keydoor_text.d_ > 0)
-                            automap_keys.push_back(
-                                {midx, midy,
-                                 (int)(line->special->keys_)});
-                    }
-                    else if (line->special->keys_ & (kDoorKeyGreenSkull | kDoorKeyGreenCard))
-                    {
-                        l->color = kRGBAGreen;
-                        DrawMLineDoor(l); // green
-                        if (automap_keydoor_text.d_ > 0)
-                            automap_keys.push_back(
-                                {midx, midy,
-                                 (int)(line->special->keys_)});
-                    }
-                    else
-                    {
-                        l->color = kRGBAPurple;
-                        DrawMLineDoor(l); // purple
-                    }
-                    return;
-                }
-            }
-            if (line->flags & kLineFlagSecret)
-            {
-                // secret door
-                if (show_walls)
-                    l->color = am_colors[kAutomapColorSecret];
-                else
-                    l->color = am_colors[kAutomapColorWall];
-                DrawMLine(l);
-            }
-            else if (!AlmostEquals(back->floor_height, front->floor_height))
-            {
-                float diff = fabs(back->floor_height - front->floor_height);
-
-                // floor level change
-                if (diff > 24)
-                    l->color = am_colors[kAutomapColorLedge];
-                else
-                    l->color = am_colors[kAutomapColorStep];
-                DrawMLine(l);
-            }
-            else if (!AlmostEquals(back->ceiling_height, front->ceiling_height))
-            {
-                // ceiling level change
-                l->color = am_colors[kAutomapColorCeil];
-                DrawMLine(l);
-            }
-            else if ((front->extrafloor_used > 0 || back->extrafloor_used > 0) &&
-                     (front->extrafloor_used != back->extrafloor_used || !CheckSimiliarRegions(front, back)))
+            int keys = line->special->keys_;
+
+            wc.kind     = kAutomapWallDoor;
+            wc.key_type = keys;
+
+            if (keys & kDoorKeyStrictlyAllKeys)
             {
-                // -AJA- 1999/10/09: extra floor change.
-                l->color = am_colors[kAutomapColorLedge];
-                DrawMLine(l);
+                wc.color    = kRGBAPurple;
+                wc.key_type = kDoorKeyStrictlyAllKeys;
             }
-            else if (show_walls)
+            else if (keys == (kDoorKeyRedCard | kDoorKeyRedSkull | kDoorKeyBlueCard | kDoorKeyBlueSkull |
+                              kDoorKeyYellowCard | kDoorKeyYellowSkull))
+                wc.color = kRGBAFuchsia;
+            else if (keys & (kDoorKeyBlueSkull | kDoorKeyBlueCard))
+                wc.color = kRGBABlue;
+            else if (keys & (kDoorKeyYellowSkull | kDoorKeyYellowCard))
+                wc.color = kRGBAYellow;
+            else if (keys & (kDoorKeyRedSkull | kDoorKeyRedCard))
+                wc.color = kRGBARed;
+            else if (keys & (kDoorKeyGreenSkull | kDoorKeyGreenCard))
+                wc.color = kRGBAGreen;
+            else
             {
-                l->color = am_colors[kAutomapColorAllmap];
-                DrawMLine(l);
-            }
-            else if (line->slide_door)
-            { // Lobo: draw sliding doors on automap
-                l->color = am_colors[kAutomapColorCeil];
-                DrawMLine(l);
+                wc.color    = kRGBAPurple;
+                wc.key_type = 0;
             }
+            return;
+        }
+
+        if (line->flags & kLineFlagSecret)
+        {
+            // secret door
+            if (show_walls)
+                wc.color = am_colors[kAutomapColorSecret];
+            else
+                wc.color = am_colors[kAutomapColorWall];
+        }
+        else if (!AlmostEquals(back->floor_height, front->floor_height))
+        {
+            float diff = fabs(back->floor_height - front->floor_height);
+
+            // floor level change
+            if (diff > 24)
+                wc.color = am_colors[kAutomapColorLedge];
+            else
+                wc.color = am_colors[kAutomapColorStep];
+        }
+        else if (!AlmostEquals(back->ceiling_height, front->ceiling_height))
+        {
+            // ceiling level change
+            wc.color = am_colors[kAutomapColorCeil];
+        }
+        else if ((front->extrafloor_used > 0 || back->extrafloor_used > 0) &&
+                 (front->extrafloor_used != back->extrafloor_used || !CheckSimiliarRegions(front, back)))
+        {
+            // -AJA- 1999/10/09: extra floor change.
+            wc.color = am_colors[kAutomapColorLedge];
+        }
+        else if (show_walls)
+        {
+            wc.color = am_colors[kAutomapColorAllmap];
+        }
+        else if (line->slide_door)
+        { // Lobo: draw sliding doors on automap
+            wc.color = am_colors[kAutomapColorCeil];
+        }
+        else
+        {
+            wc.kind = kAutomapWallHidden;
         }
     }
-    else if (frame_focus->player_ &&
-             (show_allmap || !AlmostEquals(frame_focus->player_->powers_[kPowerTypeAllMap], 0.0f)))
+    else if (allmap)
     {
         if (!(line->flags & kLineFlagDontDraw))
         {
-            AutomapLine *l = GetMapLine();
-            GetRotatedCoords(line->vertex_1->X, line->vertex_1->Y, l->points.X, l->points.Y);
-            GetRotatedCoords(line->vertex_2->X, line->vertex_2->Y, l->points.Z, l->points.W);
+            wc.kind  = kAutomapWallNormal;
+            wc.color = am_colors[kAutomapColorAllmap];
+        }
+    }
+}
+
+//
+// Brings the wall cache up to date, re-classifying only those lines
+// reported as changed, and rebuilds the batches if anything did.
+//
+static void UpdateWallCache(void)
+{
+    bool allmap = frame_focus->player_ &&
+                  (show_allmap || !AlmostEquals(frame_focus->player_->powers_[kPowerTypeAllMap], 0.0f));
+
+    int mode = (show_walls ? 1 : 0) | (allmap ? 2 : 0);
+
+    if ((int)wall_cache.size() != total_level_lines)
+    {
+        wall_cache.resize(total_level_lines);
+        wall_cache_mode = -1;
+    }
+
+    if (mode != wall_cache_mode)
+    {
+        for (int i = 0; i < total_level_lines; i++)
+            ClassifyWall(&level_lines[i], wall_cache[i], allmap);
+
+        changed_walls.clear();
+
+        wall_cache_mode    = mode;
+        wall_batches_dirty = true;
+    }
+    else
+    {
+        for (int i : changed_walls)
+        {
+            AutomapWallCache &wc = wall_cache[i];
+
+            AutomapWallKind old_kind  = wc.kind;
+            RGBAColor       old_color = wc.color;
+            int             old_key   = wc.key_type;
+
+            ClassifyWall(&level_lines[i], wc, allmap);
+
+            if (wc.kind != old_kind || (wc.kind != kAutomapWallHidden && (wc.color != old_color || wc.key_type != old_key)))
+                wall_batches_dirty = true;
+        }
+
+        changed_walls.clear();
+    }
+
+    if (!wall_batches_dirty)
+        return;
+
+    wall_batches[0].clear();
+    wall_batches[1].clear();
+
+    for (int i = 0; i < total_level_lines; i++)
+    {
+        const AutomapWallCache &wc = wall_cache[i];
+
+        if (wc.kind == kAutomapWallHidden)
+            continue;
+
+        const Line *line = &level_lines[i];
+
+        AutomapCachedLine cl;
+
+        cl.points   = {{line->vertex_1->X, line->vertex_1->Y, line->vertex_2->X, line->vertex_2->Y}};
+        cl.color    = wc.color;
+        cl.key_type = wc.key_type;
+
+        wall_batches[wc.kind == kAutomapWallDoor ? 1 : 0].push_back(cl);
+    }
+
+    wall_batches_dirty = false;
+}
+
+//
+// Combines rotation, panning and zoom into one world-to-frame transform.
+//
+static void GetWallTransform(AutomapTransform &t)
+{
+    float c  = 1.0f;
+    float s  = 0.0f;
+    float rx = 0.0f;
+    float ry = 0.0f;
+
+    if (rotate_map)
+    {
+        float    px, py;
+        BAMAngle ang;
+
+        GetRotationPivot(px, py, ang);
+
+        c  = epi::BAMCos(ang);
+        s  = epi::BAMSin(ang);
+        rx = px - c * px + s * py;
+        ry = py - s * px - c * py;
+    }
+
+    float kx = MapToFrameDistanceX(1.0f);
+    float ky = MapToFrameDistanceY(1.0f);
+    float ox = frame_x + frame_width * 0.5f;
+    float oy = frame_y + frame_height * 0.5f;
+
+    t.xx = kx * c;
+    t.xy = -kx * s;
+    t.tx = ox + kx * (rx - map_center_x);
+
+    t.yx = -ky * s;
+    t.yy = -ky * c;
+    t.ty = oy - ky * (ry - map_center_y);
+}
+
+//
+// Transforms the cached wall batches, culls them to the map frame
+// and hands them to the line buckets.
+//
+static void AddCachedWalls(void)
+{
+    AutomapTransform t;
+
+    GetWallTransform(t);
+
+    float left   = frame_x;
+    float right  = frame_x + frame_width;
+    float top    = frame_y;
+    float bottom = frame_y + frame_height;
+
+    for (int b = 0; b < 2; b++)
+    {
+        bool door = (b == 1);
+
+        for (const AutomapCachedLine &cl : wall_batches[b])
+        {
+            float x1 = t.xx * cl.points.X + t.xy * cl.points.Y + t.tx;
+            float y1 = t.yx * cl.points.X + t.yy * cl.points.Y + t.ty;
+            float x2 = t.xx * cl.points.Z + t.xy * cl.points.W + t.tx;
+            float y2 = t.yx * cl.points.Z + t.yy * cl.points.W + t.ty;
+
             // clip to map frame
-            float x1 = MapToFrameCoordinatesX(l->points.X, map_center_x);
-            float x2 = MapToFrameCoordinatesX(l->points.Z, map_center_x);
-            float y1 = MapToFrameCoordinatesY(l->points.Y, map_center_y);
-            float y2 = MapToFrameCoordinatesY(l->points.W, map_center_y);
-            if ((x1 < frame_x && x2 < frame_x) || (x1 > frame_x + frame_width && x2 > frame_x + frame_width) ||
-                (y1 < frame_y && y2 < frame_y) || (y1 > frame_y + frame_height && y2 > frame_y + frame_height))
+            if ((x1 < left && x2 < left) || (x1 > right && x2 > right) || (y1 < top && y2 < top) ||
+                (y1 > bottom && y2 > bottom))
+                continue;
+
+            AutomapLine *ml = GetMapLine();
+
+            ml->points.X = HUDToRealCoordinatesX(x1);
+            ml->points.Y = HUDToRealCoordinatesY(y1);
+            ml->points.Z = HUDToRealCoordinatesX(x2);
+            ml->points.W = HUDToRealCoordinatesY(y2);
+            ml->color    = cl.color;
+
+            epi::SetRGBAAlpha(ml->color, map_alpha);
+
+            if (!door)
             {
-                automap_line_position--;
-                return;
+                map_line_pointers[1].push_back(ml); // 1.5f
+                continue;
             }
-            l->color = am_colors[kAutomapColorAllmap];
-            DrawMLine(l);
+
+            // Lobo 2023: Make keyed doors pulse
+            if (automap_keydoor_blink)
+                map_line_pointers[3].push_back(ml); // variable pulse width
+            else
+                map_line_pointers[2].push_back(ml); // 3.5f
+
+            if (cl.key_type && automap_keydoor_text.d_ > 0)
+                automap_keys.push_back({(x1 + x2) / 2, (y1 + y2) / 2, cl.key_type});
         }
     }
 }
@@ -1344,10 +1509,8 @@ static void CollectMapLines()
 {
     if (!hide_lines)
     {
-        for (int i = 0; i < total_level_lines; i++)
-        {
-            AddWall(&level_lines[i]);
-        }
+        UpdateWallCache();
+        AddCachedWalls();
     }
 
     // draw player arrows first, then things
@@ -1475,6 +1638,9 @@ void AutomapSetColor(int which, RGBAColor color)
 {
     EPI_ASSERT(0 <= which && which < kTotalAutomapColors);
 
+    if (am_colors[which] != color)
+        InvalidateWallCache();
+
     am_colors[which] = color;
 }
 
@@ -31,6 +31,9 @@
 #include "e_event.h"
 #include "p_mobj.h"
 
+struct Line;
+struct Sector;
+
 // NOTE: these numbers here must match the COAL API script
 enum AutomapColor
 {
@@ -82,6 +85,14 @@ extern ConsoleVariable            automap_keydoor_text;
 
 void AutomapInitLevel(void);
 
+// Tells the automap that something it draws a line from (mapped flag,
+// special, sliding door, or the heights and extrafloors either side) has
+// changed, so only that line is re-classified on the next render.
+void AutomapLineChanged(Line *ld);
+
+// The same for every line of a sector whose heights or extrafloors moved.
+void AutomapSectorChanged(Sector *sec);
+
 // Called by main loop.
 bool AutomapResponder(InputEvent *ev);
 
@@ -45,6 +45,7 @@
 #include "i_movie.h"
 #include "i_system.h"
 #include "m_argv.h"
+#include "m_profile.h"
 #include "n_network.h"
 #include "r_backend.h"
 #include "r_draw.h"
@@ -60,6 +61,7 @@ static constexpr uint8_t kConsoleWipeTics = 12;
 
 EDGE_DEFINE_CONSOLE_VARIABLE(debug_fps, "0", kConsoleVariableFlagArchive)
 EDGE_DEFINE_CONSOLE_VARIABLE(debug_position, "0", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(debug_profile, "0", kConsoleVariableFlagNone)
 
 static ConsoleVisibility console_visible;
 
@@ -1677,6 +1679,62 @@ void ConsoleShowPosition(void)
     FinishUnitBatch();
 }
 
+void ConsoleShowProfile(void)
+{
+    if (debug_profile.d_ <= 0)
+        return;
+
+    int count = 0;
+
+    for (int i = 0; i < ProfileZoneCount(); i++)
+    {
+        if (ProfileGetZone(i)->shown_calls_ > 0)
+            count++;
+    }
+
+    if (count == 0)
+        return;
+
+    StartUnitBatch(false);
+
+    ConsoleSetupFont();
+
+    int x = 0;
+    int y = FNSZ * (count + 1) + 2;
+
+    SolidBox(x, 0, XMUL * 44, y, kRGBABlack, 0.5);
+
+    RendererVertex *console_glvert = StartText();
+    uint16_t        console_verts  = 0;
+
+    x += XMUL;
+    y -= FNSZ * (console_font->definition_->type_ == kFontTypeTrueType ? 0.25 : 1.25);
+
+    char textbuf[128];
+
+    stbsp_sprintf(textbuf, "%-22s %6s %6s %5s", "scope", "avg", "max", "calls");
+    console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
+
+    for (int i = 0; i < ProfileZoneCount(); i++)
+    {
+        ProfileZone *zone = ProfileGetZone(i);
+
+        if (zone->shown_calls_ <= 0)
+            continue;
+
+        // indent nested scopes under their parents
+        int indent = HMM_MIN(zone->depth_, 6);
+
+        y -= FNSZ;
+        stbsp_sprintf(textbuf, "%*s%-*.*s %6.2f %6.2f %5.0f", indent, "", 22 - indent, 22 - indent, zone->name_,
+                      zone->shown_average_, zone->shown_worst_, zone->shown_calls_);
+        console_verts += AddText(x, y, textbuf, kRGBAWebGray, console_glvert);
+    }
+
+    EndRenderUnit(console_verts);
+    FinishUnitBatch();
+}
+
 void ConsoleENDOOM()
 {
     if (quit_lines[0] && quit_lines[0]->endoom_bytes_.size() == kENDOOMBytesPerLine)
@@ -32,6 +32,7 @@ void ConsoleDrawer(void);
 
 void ConsoleShowFPS(void);
 void ConsoleShowPosition(void);
+void ConsoleShowProfile(void);
 
 void ConsoleInit(void);
 
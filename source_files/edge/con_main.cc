@@ -30,12 +30,15 @@
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
 #include "g_game.h"
+#include "i_pacing.h"
 #include "i_system.h"
 #include "m_menu.h"
 #include "m_misc.h"
+#include "m_profile.h"
 #include "p_local.h"
 #include "r_misc.h"
 #include "s_sound.h"
+#include "script/compat/lua_compat.h"
 #include "stb_sprintf.h"
 #include "version.h"
 #include "w_files.h"
@@ -670,6 +673,33 @@ int ConsoleCommandShowGamepads(char **argv, int argc)
     return 0;
 }
 
+int ConsoleCommandLuaStats(char **argv, int argc)
+{
+    EPI_UNUSED(argv);
+    EPI_UNUSED(argc);
+
+    LuaPrintMemoryStats();
+    return 0;
+}
+
+int ConsoleCommandSoundStats(char **argv, int argc)
+{
+    EPI_UNUSED(argv);
+    EPI_UNUSED(argc);
+
+    SoundPrintStats();
+    return 0;
+}
+
+int ConsoleCommandFrameStats(char **argv, int argc)
+{
+    EPI_UNUSED(argv);
+    EPI_UNUSED(argc);
+
+    PacingPrintStats();
+    return 0;
+}
+
 int ConsoleCommandHelp(char **argv, int argc)
 {
     EPI_UNUSED(argv);
@@ -728,6 +758,31 @@ int ConsoleCommandClear(char **argv, int argc)
     return 0;
 }
 
+int ConsoleCommandProfileTrace(char **argv, int argc)
+{
+#ifdef EDGE_PROFILING
+    int frames = 300;
+
+    if (argc >= 2)
+        frames = atoi(argv[1]);
+
+    if (frames <= 0)
+    {
+        ConsoleMessage(kConsoleOnly, "Usage: profile_trace [frames]\n");
+        return 1;
+    }
+
+    ProfileStartCapture(frames);
+    LogPrint("Capturing profile trace for %d frames...\n", frames);
+    return 0;
+#else
+    EPI_UNUSED(argv);
+    EPI_UNUSED(argc);
+    LogPrint("This build does not include the profiler.\n");
+    return 1;
+#endif
+}
+
 //----------------------------------------------------------------------------
 
 // oh lordy....
@@ -806,9 +861,13 @@ const ConsoleCommand builtin_commands[] = {{"cat", ConsoleCommandType},
                                            {"endtext", ConsoleCommandEndoom},
                                            {"exec", ConsoleCommandExec},
                                            {"help", ConsoleCommandHelp},
+                                           {"luastats", ConsoleCommandLuaStats},
+                                           {"framestats", ConsoleCommandFrameStats},
+                                           {"soundstats", ConsoleCommandSoundStats},
                                            {"map", ConsoleCommandMap},
                                            {"warp", ConsoleCommandMap}, // compatibility
                                            {"playsound", ConsoleCommandPlaySound},
+                                           {"profile_trace", ConsoleCommandProfileTrace},
                                            {"readme", ConsoleCommandReadme},
                                            {"browse", ConsoleCommandBrowse},
                                            {"pwd", ConsoleCommandPrintWorkingDir},
@@ -114,6 +114,9 @@ extern int quicksave_slot;
 // debug flag to cancel adaptiveness
 extern bool single_tics;
 
+// -benchmark: no window, GL context, audio or input
+extern bool headless_mode;
+
 // Needed to store the number of the dummy sky flat.
 // Used for rendering, as well as tracking projectiles etc.
 
@@ -33,6 +33,7 @@ constexpr const char *kSaveGameBase      = "save";
 constexpr const char *kSaveGameExtension = "esg";
 
 constexpr const char *kCacheDirectory      = "cache";
+constexpr const char *kImageCacheDirectory = "textures";
 constexpr const char *kSaveGameDirectory   = "savegame";
 constexpr const char *kScreenshotDirectory = "screenshot";
 
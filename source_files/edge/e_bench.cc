@@ -0,0 +1,506 @@
+//----------------------------------------------------------------------------
+//  EDGE Headless Playsim Benchmark
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "e_bench.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+#include <new>
+
+#include "HandmadeMath.h"
+#include "coal.h"
+#include "ddf_main.h"
+#include "dm_state.h"
+#include "e_player.h"
+#include "epi_str_compare.h"
+#include "g_game.h"
+#include "i_pacing.h"
+#include "i_system.h"
+#include "im_data.h"
+#include "im_filter.h"
+#include "m_argv.h"
+#include "n_network.h"
+#include "p_local.h"
+#include "r_colormap.h"
+#include "r_image.h"
+#include "vm_coal.h"
+
+static constexpr int      kBenchmarkDefaultTics = 60 * kTicRate;
+static constexpr uint64_t kBenchmarkSeed        = 0x45444745ull; // "EDGE"
+static constexpr float    kBenchmarkBlurSigma   = 2.0f;
+static constexpr int      kBenchmarkPasses      = 5;
+static constexpr int      kBenchmarkCOALCalls   = 200;
+
+#ifdef EDGE_BENCHMARK
+// Every C++ allocation in the program is counted, which is cheap enough
+// for a benchmark build but not something the normal engine pays for.
+static std::atomic<uint64_t> allocation_count{0};
+static std::atomic<uint64_t> allocation_bytes{0};
+
+void *operator new(size_t size)
+{
+    allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_bytes.fetch_add(size, std::memory_order_relaxed);
+
+    void *ptr = malloc(size ? size : 1);
+    if (!ptr)
+        abort();
+    return ptr;
+}
+
+void *operator new[](size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept
+{
+    free(ptr);
+}
+
+void operator delete(void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+
+void operator delete[](void *ptr, size_t) noexcept
+{
+    free(ptr);
+}
+#endif
+
+struct BenchmarkCounters
+{
+    uint64_t time;
+    uint64_t allocations;
+    uint64_t bytes;
+};
+
+static void ReadCounters(BenchmarkCounters &c)
+{
+    c.time = PacingGetNanoseconds();
+#ifdef EDGE_BENCHMARK
+    c.allocations = allocation_count.load(std::memory_order_relaxed);
+    c.bytes       = allocation_bytes.load(std::memory_order_relaxed);
+#else
+    c.allocations = c.bytes = 0;
+#endif
+}
+
+//
+// Scripted input for the console player: run forward, sweep round, fire
+// and press use on a fixed cycle.  Driven off game_tic only, so the same
+// map/skill/seed always produces the same simulation.
+//
+static void BenchmarkPlayerBuilder(const Player *p, void *data, EventTicCommand *cmd)
+{
+    EPI_UNUSED(data);
+    EPI_CLEAR_MEMORY(cmd, EventTicCommand, 1);
+
+    if (game_state != kGameStateLevel)
+        return;
+
+    int phase = game_tic % (4 * kTicRate);
+
+    cmd->player_index = p->player_number_;
+
+    if (phase < 3 * kTicRate)
+    {
+        cmd->forward_move = 50;
+        cmd->side_move    = (phase / kTicRate == 1) ? 24 : 0;
+    }
+    else
+        cmd->angle_turn = 640;
+
+    if ((game_tic % 8) == 0)
+        cmd->buttons |= kButtonCodeAttack;
+    if ((game_tic % 20) == 0)
+        cmd->buttons |= kButtonCodeUse;
+}
+
+static void BenchmarkMap(const MapDefinition *map, int tics, SkillLevel skill, int bots)
+{
+    NewGameParameters params;
+
+    params.map_         = map;
+    params.skill_       = skill;
+    params.deathmatch_  = 0;
+    params.level_skip_  = true;
+    params.random_seed_ = kBenchmarkSeed;
+
+    params.SinglePlayer(bots);
+
+    BenchmarkCounters start, loaded, done;
+
+    ReadCounters(start);
+
+    DeferredNewGame(params);
+    DoBigGameStuff();
+
+    ReadCounters(loaded);
+
+    if (game_state != kGameStateLevel)
+    {
+        LogWarning("Benchmark: %s did not start, skipping.\n", map->name_.c_str());
+        return;
+    }
+
+    players[console_player]->Builder     = BenchmarkPlayerBuilder;
+    players[console_player]->build_data_ = nullptr;
+
+    int ran = 0;
+
+    // stop at the first exit, the intermission isn't worth measuring
+    for (; ran < tics && game_state == kGameStateLevel; ran++)
+    {
+        NetworkBuildTicCommands();
+        GameTicker();
+        DoBigGameStuff();
+    }
+
+    ReadCounters(done);
+
+    double setup_ms = (loaded.time - start.time) / 1e6;
+    double run_sec  = (done.time - loaded.time) / 1e9;
+    double tps      = run_sec > 0 ? ran / run_sec : 0;
+
+    uint64_t setup_allocs = loaded.allocations - start.allocations;
+    uint64_t run_allocs   = done.allocations - loaded.allocations;
+    uint64_t run_bytes    = done.bytes - loaded.bytes;
+
+    LogPrint("Benchmark: %-8s setup %8.2f ms  %6d tics  %9.1f tics/sec  allocs %llu + %llu (%llu bytes)\n",
+             map->name_.c_str(), setup_ms, ran, tps, (unsigned long long)setup_allocs,
+             (unsigned long long)run_allocs, (unsigned long long)run_bytes);
+
+    // machine readable copy for CI
+    printf("BENCH\t%s\t%.3f\t%d\t%.1f\t%llu\t%llu\t%llu\n", map->name_.c_str(), setup_ms, ran, tps,
+           (unsigned long long)setup_allocs, (unsigned long long)run_allocs, (unsigned long long)run_bytes);
+    fflush(stdout);
+}
+
+static void BenchmarkPlaysim(void)
+{
+    int tics = kBenchmarkDefaultTics;
+
+    std::string s = ArgumentValue("benchtics");
+    if (!s.empty())
+        tics = HMM_MAX(1, atoi(s.c_str()));
+
+    SkillLevel skill = kSkillMedium;
+
+    s = ArgumentValue("skill");
+    if (!s.empty())
+        skill = (SkillLevel)HMM_Clamp(0, atoi(s.c_str()) - 1, kSkillNightmare);
+
+    int bots = 0;
+
+    s = ArgumentValue("bots");
+    if (!s.empty())
+        bots = atoi(s.c_str());
+
+    std::string only_map = ArgumentValue("benchmap");
+
+#ifndef EDGE_BENCHMARK
+    LogPrint("Benchmark: allocation counts need an EDGE_BENCHMARK build.\n");
+#endif
+
+    printf("BENCH\tmap\tsetup_ms\ttics\ttics_per_sec\tsetup_allocs\trun_allocs\trun_bytes\n");
+
+    int count = 0;
+
+    for (const MapDefinition *map : mapdefs)
+    {
+        if (!MapExists(map) || !map->episode_)
+            continue;
+
+        if (!only_map.empty() && epi::StringCaseCompareASCII(only_map, map->name_) != 0)
+            continue;
+
+        BenchmarkMap(map, tics, skill, bots);
+        count++;
+    }
+
+    if (count == 0)
+        FatalError("Benchmark: no playable maps found.\n");
+}
+
+//
+// -benchmark filters: HQ2x over every palettised graphic, texture, flat
+// and sprite of the loaded wads, then a blur of the results, once with
+// the SSE2/NEON path and once more with AVX2 when the CPU has it.
+//
+static void BenchmarkBlur(const std::vector<ImageData *> &images, const char *name)
+{
+    // ImageBlur() leaves the horizontal pass in its input, so work on
+    // copies made before the clock starts
+    std::vector<ImageData *> copies;
+
+    uint64_t pixels = 0;
+
+    for (const ImageData *img : images)
+    {
+        ImageData *copy = new ImageData(img->width_, img->height_, img->depth_);
+        memcpy(copy->pixels_, img->pixels_, img->width_ * img->height_ * img->depth_);
+        copies.push_back(copy);
+
+        pixels += img->width_ * img->height_;
+    }
+
+    uint64_t start = PacingGetNanoseconds();
+
+    for (ImageData *img : copies)
+        delete ImageBlur(img, kBenchmarkBlurSigma);
+
+    double run_sec = (PacingGetNanoseconds() - start) / 1e9;
+
+    for (ImageData *img : copies)
+        delete img;
+
+    LogPrint("Benchmark: %-12s %6d images  %8.2f ms  %8.1f Mpixels/sec\n", name, (int)images.size(), run_sec * 1e3,
+             run_sec > 0 ? pixels / run_sec / 1e6 : 0);
+
+    printf("BENCH\t%s\t%d\t%.3f\t%.1f\n", name, (int)images.size(), run_sec * 1e3,
+           run_sec > 0 ? pixels / run_sec / 1e6 : 0);
+}
+
+static void BenchmarkImageFilters(void)
+{
+    std::vector<ImageData *> blocks;
+
+    ImageReadAllBlocks(blocks);
+
+    if (blocks.empty())
+        FatalError("Benchmark: no palettised images found.\n");
+
+    static HQ2xPalette palette;
+
+    HQ2xPaletteSetup(&palette, &playpal_data[0][0][0], kTransparentPixelIndex);
+
+    printf("BENCH\tfilter\timages\tms\tmpixels_per_sec\n");
+
+    std::vector<ImageData *> scaled;
+
+    uint64_t pixels = 0;
+    uint64_t start  = PacingGetNanoseconds();
+
+    for (ImageData *img : blocks)
+    {
+        scaled.push_back(ImageHQ2x(&palette, img, false));
+        pixels += img->width_ * img->height_;
+    }
+
+    double run_sec = (PacingGetNanoseconds() - start) / 1e9;
+
+    LogPrint("Benchmark: %-12s %6d images  %8.2f ms  %8.1f Mpixels/sec\n", "hq2x", (int)blocks.size(), run_sec * 1e3,
+             run_sec > 0 ? pixels / run_sec / 1e6 : 0);
+
+    printf("BENCH\t%s\t%d\t%.3f\t%.1f\n", "hq2x", (int)blocks.size(), run_sec * 1e3,
+           run_sec > 0 ? pixels / run_sec / 1e6 : 0);
+
+    // the box blur wants a few pixels more than its radius each way
+    std::vector<ImageData *> blurrable;
+
+    for (ImageData *img : scaled)
+    {
+        if (img->width_ >= 16 && img->height_ >= 16)
+            blurrable.push_back(img);
+    }
+
+    bool has_avx2 = image_filter_avx2;
+
+    image_filter_avx2 = false;
+    BenchmarkBlur(blurrable, "blur");
+
+    if (has_avx2)
+    {
+        image_filter_avx2 = true;
+        BenchmarkBlur(blurrable, "blur (avx2)");
+    }
+
+    for (ImageData *img : blocks)
+        delete img;
+    for (ImageData *img : scaled)
+        delete img;
+
+    fflush(stdout);
+}
+
+static int BenchmarkPasses(void)
+{
+    std::string s = ArgumentValue("benchpasses");
+
+    return s.empty() ? kBenchmarkPasses : HMM_MAX(1, atoi(s.c_str()));
+}
+
+//
+// -benchmark ddf: parse the DDF text of all loaded files again (as the
+// startup parse did, minus RTS), several times over.
+//
+static void BenchmarkDDF(void)
+{
+    int passes = BenchmarkPasses();
+
+    printf("BENCH\tpass\tbytes\tms\tmb_per_sec\n");
+
+    for (int pass = 1; pass <= passes; pass++)
+    {
+        uint64_t start = PacingGetNanoseconds();
+
+        size_t bytes = DDFReparseText();
+
+        double run_sec = (PacingGetNanoseconds() - start) / 1e9;
+
+        if (bytes == 0)
+            FatalError("Benchmark: no DDF text was loaded.\n");
+
+        LogPrint("Benchmark: ddf pass %d  %8zu bytes  %8.2f ms  %8.2f MB/sec\n", pass, bytes, run_sec * 1e3,
+                 run_sec > 0 ? bytes / run_sec / 1e6 : 0);
+
+        printf("BENCH\t%d\t%zu\t%.3f\t%.2f\n", pass, bytes, run_sec * 1e3, run_sec > 0 ? bytes / run_sec / 1e6 : 0);
+    }
+
+    fflush(stdout);
+}
+
+//
+// -benchmark coal: a fixed script run in a VM of its own, so the numbers
+// only depend on the interpreter.  One call of run() is well under the
+// VM's runaway limit.
+//
+static const char *kBenchmarkCOALScript = "module bench\n"
+                                          "{\n"
+                                          "    var total\n"
+                                          "    var text : string\n"
+                                          "\n"
+                                          "    function fib(n) : float =\n"
+                                          "    {\n"
+                                          "        if (n < 2) return n\n"
+                                          "        return fib(n - 1) + fib(n - 2)\n"
+                                          "    }\n"
+                                          "\n"
+                                          "    function collatz(n) : float =\n"
+                                          "    {\n"
+                                          "        var steps = 0\n"
+                                          "        while (n != 1)\n"
+                                          "        {\n"
+                                          "            if (n % 2 == 0)\n"
+                                          "                n = n / 2\n"
+                                          "            else\n"
+                                          "                n = n * 3 + 1\n"
+                                          "            steps = steps + 1\n"
+                                          "        }\n"
+                                          "        return steps\n"
+                                          "    }\n"
+                                          "\n"
+                                          "    function spin(v : vector) : vector =\n"
+                                          "    {\n"
+                                          "        var i\n"
+                                          "        var w : vector = '0 0 0'\n"
+                                          "        for (i = 1, 200)\n"
+                                          "        {\n"
+                                          "            w = w + v * i\n"
+                                          "            v = v * 0.5 + '1 2 3'\n"
+                                          "        }\n"
+                                          "        return w\n"
+                                          "    }\n"
+                                          "\n"
+                                          "    function run() =\n"
+                                          "    {\n"
+                                          "        var i\n"
+                                          "        var acc = 0\n"
+                                          "        for (i = 1, 200)\n"
+                                          "            acc = acc + collatz(i)\n"
+                                          "        acc = acc + fib(16)\n"
+                                          "        spin('1 1 1')\n"
+                                          "        text = \"\"\n"
+                                          "        for (i = 1, 100)\n"
+                                          "        {\n"
+                                          "            if (i % 10 == 0)\n"
+                                          "                text = \"n\" + i\n"
+                                          "        }\n"
+                                          "        total = acc\n"
+                                          "    }\n"
+                                          "}\n";
+
+static void BenchmarkCOAL(void)
+{
+    int passes = BenchmarkPasses();
+
+    coal::VM *vm = coal::CreateVM();
+
+    vm->SetPrinter(COALPrinter);
+
+    std::string source = kBenchmarkCOALScript;
+
+    if (!vm->CompileFile(&source[0], "benchmark"))
+        FatalError("Benchmark: COAL script failed to compile.\n");
+
+    int func = vm->FindFunction("run");
+
+    printf("BENCH\tpass\tinstructions\tms\tminstructions_per_sec\n");
+
+    for (int pass = 1; pass <= passes; pass++)
+    {
+        uint64_t count = vm->GetInstructionCount();
+        uint64_t start = PacingGetNanoseconds();
+
+        for (int i = 0; i < kBenchmarkCOALCalls; i++)
+            vm->Execute(func);
+
+        double run_sec = (PacingGetNanoseconds() - start) / 1e9;
+
+        count = vm->GetInstructionCount() - count;
+
+        LogPrint("Benchmark: coal pass %d  %10llu instructions  %8.2f ms  %8.1f Minstructions/sec\n", pass,
+                 (unsigned long long)count, run_sec * 1e3, run_sec > 0 ? count / run_sec / 1e6 : 0);
+
+        printf("BENCH\t%d\t%llu\t%.3f\t%.1f\n", pass, (unsigned long long)count, run_sec * 1e3,
+               run_sec > 0 ? count / run_sec / 1e6 : 0);
+    }
+
+    coal::DeleteVM(vm);
+
+    fflush(stdout);
+}
+
+void BenchmarkRun(void)
+{
+    std::string mode = ArgumentValue("benchmark");
+
+    if (mode.empty() || epi::StringCaseCompareASCII(mode, "playsim") == 0)
+        BenchmarkPlaysim();
+    else if (epi::StringCaseCompareASCII(mode, "filters") == 0)
+        BenchmarkImageFilters();
+    else if (epi::StringCaseCompareASCII(mode, "ddf") == 0)
+        BenchmarkDDF();
+    else if (epi::StringCaseCompareASCII(mode, "coal") == 0)
+        BenchmarkCOAL();
+    else
+        FatalError("Benchmark: unknown mode '%s' (playsim, filters, ddf, coal)\n", mode.c_str());
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
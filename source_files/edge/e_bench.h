@@ -0,0 +1,40 @@
+//----------------------------------------------------------------------------
+//  EDGE Headless Playsim Benchmark
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+// Only used in headless mode (-benchmark [mode]), where no window, GL
+// context or audio device is ever created.  The modes are:
+//
+//   playsim  (default) runs every map (or just -benchmap) for -benchtics
+//            tics with scripted input and a fixed random seed, printing
+//            the setup time, tics per second and (in EDGE_BENCHMARK
+//            builds) allocation counts for each one.
+//
+//   filters  HQ2x and blur over every palettised image in the wads.
+//
+//   ddf      parses all the DDF text again, -benchpasses times (default
+//            5), printing MB/sec for each pass.
+//
+//   coal     runs a built-in COAL script in a VM of its own, -benchpasses
+//            times, printing instructions per second for each pass.
+//
+void BenchmarkRun(void);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -47,9 +47,11 @@
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "dstrings.h"
+#include "e_bench.h"
 #include "e_input.h"
 #include "epi_file.h"
 #include "epi_filesystem.h"
+#include "epi_md5.h"
 #include "epi_sdl.h"
 #include "epi_str_compare.h"
 #include "epi_str_hash.h"
@@ -69,6 +71,7 @@
 #include "m_cheat.h"
 #include "m_menu.h"
 #include "m_misc.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "n_network.h"
 #include "p_setup.h"
@@ -111,6 +114,7 @@ ECFrameStats ec_frame_stats;
 int app_state = kApplicationActive;
 
 bool single_tics = false; // debug flag to cancel adaptiveness
+bool headless_mode = false;
 
 static bool need_wipe = false;
 
@@ -197,6 +201,7 @@ EDGE_DEFINE_CONSOLE_VARIABLE(force_infighting, "0", kConsoleVariableFlagArchive)
 EDGE_DEFINE_CONSOLE_VARIABLE(ddf_strict, "0", kConsoleVariableFlagArchive)
 EDGE_DEFINE_CONSOLE_VARIABLE(ddf_lax, "0", kConsoleVariableFlagArchive)
 EDGE_DEFINE_CONSOLE_VARIABLE(ddf_quiet, "0", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(ddf_cache, "1", kConsoleVariableFlagArchive)
 
 EDGE_DEFINE_CONSOLE_VARIABLE(skip_intros, "0", kConsoleVariableFlagArchive)
 
@@ -341,7 +346,9 @@ static StartupProgress startup_progress;
 void StartupProgressMessage(const char *message)
 {
     startup_progress.AddMessage(message);
-    startup_progress.DrawIt();
+
+    if (!headless_mode)
+        startup_progress.DrawIt();
 }
 
 //
@@ -459,6 +466,17 @@ static void SetGlobalVariables(void)
 
     CheckBooleanParameter("automap_keydoor_blink", &automap_keydoor_blink, false);
 
+    if (FindArgument("benchmark") > 0)
+    {
+        headless_mode = true;
+        no_sound      = true;
+        no_music      = true;
+
+        // -benchmark ddf parses the text again after startup
+        if (epi::StringCaseCompareASCII(ArgumentValue("benchmark"), "ddf") == 0)
+            ddf_keep_text = true;
+    }
+
     if (FindArgument("infight") > 0)
         force_infighting = 1;
 
@@ -569,6 +587,17 @@ static void DoSystemStartup(void)
 
     LogDebug("- System startup begun.\n");
 
+    // nothing to draw on, so only the sizes the HUD code expects
+    if (headless_mode)
+    {
+        current_screen_width  = 640;
+        current_screen_height = 400;
+        current_screen_depth  = 32;
+
+        LogDebug("- Headless, skipping video/audio/input startup.\n");
+        return;
+    }
+
     SystemStartup();
 
     // -ES- 1998/09/11 Use ChangeResolution to enter gfx mode
@@ -614,7 +643,7 @@ void ForceWipe(void)
     // tick Disabled on the platform until can be better integrated
     return;
 #else
-    if (game_state == kGameStateNothing)
+    if (game_state == kGameStateNothing || headless_mode)
         return;
 
     if (wipe_method == kScreenWipeNone)
@@ -638,6 +667,8 @@ static bool wipe_gl_active = false;
 
 void EdgeDisplay(void)
 {
+    EDGE_PROFILE_SCOPE("EdgeDisplay");
+
     // Start the frame - should we need to.
     StartFrame();
 
@@ -1039,6 +1070,7 @@ static void PickMenuBackdrop(void)
         new_backdrop->offset_x_          = menu_image->offset_x_;
         new_backdrop->offset_y_          = menu_image->offset_y_;
         new_backdrop->opacity_           = menu_image->opacity_;
+        new_backdrop->source_opacity_    = menu_image->source_opacity_;
         new_backdrop->scale_x_           = menu_image->scale_x_;
         new_backdrop->scale_y_           = menu_image->scale_y_;
         new_backdrop->source_graphic_    = menu_image->source_graphic_;
@@ -1070,6 +1102,7 @@ static void PickMenuBackdrop(void)
         new_backdrop->offset_x_          = loading_image->offset_x_;
         new_backdrop->offset_y_          = loading_image->offset_y_;
         new_backdrop->opacity_           = loading_image->opacity_;
+        new_backdrop->source_opacity_    = loading_image->source_opacity_;
         new_backdrop->scale_x_           = loading_image->scale_x_;
         new_backdrop->scale_y_           = loading_image->scale_y_;
         new_backdrop->source_graphic_    = loading_image->source_graphic_;
@@ -2101,6 +2134,23 @@ static void InitializeDDF(void)
     DDFInit();
 }
 
+//
+// The parse of all DDF/RTS input is cached under a name made from the
+// ordered hashes of that input and the engine version, so any change
+// to either simply misses.
+//
+static std::string DDFCacheFilename(void)
+{
+    if (!ddf_cache.d_ || cache_directory.empty())
+        return "";
+
+    std::string key = epi::StringFormat("%s:%s", DDFUnreadHash().c_str(), edge_version.c_str());
+
+    epi::MD5Hash key_md5((const uint8_t *)key.data(), (unsigned int)key.size());
+
+    return epi::PathAppend(cache_directory, "ddf-" + key_md5.ToString() + ".edc");
+}
+
 void EdgeShutdown(void)
 {
     StopMusic();
@@ -2163,7 +2213,7 @@ static void EdgeStartup(void)
 
     InitializeRADScripts();
     ProcessMultipleFiles();
-    DDFParseEverything();
+    DDFParseEverything(DDFCacheFilename());
 
     // Must be done after WAD and DDF loading to check for potential
     // overrides of lump-specific image/sound/DDF defines
@@ -2351,6 +2401,12 @@ void EdgeMain(int argc, const char **argv)
 
     EdgeStartup();
 
+    if (headless_mode)
+    {
+        BenchmarkRun();
+        return;
+    }
+
     InitialState();
 
     ConsoleMessageColor(kRGBAYellow);
@@ -2393,6 +2449,8 @@ void EdgeIdle(void)
 //
 void EdgeTicker(void)
 {
+    ProfileStartFrame();
+
     DoBigGameStuff();
 
     // Update display, next frame, with current state.
@@ -2417,6 +2475,8 @@ void EdgeTicker(void)
         // process mouse and keyboard events
         NetworkUpdate();
     }
+
+    ProfileFinishFrame();
 }
 
 //--- editor settings ---
@@ -46,6 +46,7 @@
 #include "i_system.h"
 #include "m_cheat.h"
 #include "m_menu.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "n_network.h"
 #include "p_setup.h"
@@ -520,6 +521,8 @@ void DoBigGameStuff(void)
 
 void GameTicker(void)
 {
+    EDGE_PROFILE_SCOPE("GameTicker");
+
     if (playing_movie)
         return;
 
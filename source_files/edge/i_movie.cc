@@ -16,6 +16,7 @@
 //
 //----------------------------------------------------------------------------
 
+#include "dm_state.h"
 #include "e_event.h"
 #include "epi.h"
 #include "epi_sdl.h"
@@ -150,6 +151,9 @@ void MovieVideoCallback(plm_t *mpeg, plm_frame_t *frame, void *user)
 
 void PlayMovie(const std::string &name)
 {
+    if (headless_mode)
+        return;
+
     MovieDefinition *movie = moviedefs.Lookup(name.c_str());
 
     if (!movie)
@@ -0,0 +1,275 @@
+//----------------------------------------------------------------------------
+//  EDGE Frame Pacing
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "i_pacing.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <errno.h>
+#include <time.h>
+#endif
+
+#include "con_var.h"
+#include "epi.h"
+#include "epi_sdl.h"
+#include "epi_windows.h"
+#include "i_system.h"
+
+#if !defined(__MINGW32__) && (defined(WIN32) || defined(_WIN32) || defined(_WIN64))
+extern HANDLE windows_timer;
+#endif
+
+// When enabled, the frame-slot wait moves from after the buffer swap to
+// just before the tic commands are built, leaving only the predicted
+// time to run the tics and render.
+EDGE_DEFINE_CONSOLE_VARIABLE(late_latching, "0", kConsoleVariableFlagArchive)
+
+static constexpr uint64_t kNanosecondsPerSecond = 1000000000ull;
+
+// timer slack bounds.  The upper one has to cover 15.6ms Windows ticks
+// when no high resolution timer is available.
+static constexpr uint64_t kMinimumSlack = 50000ull;
+static constexpr uint64_t kMaximumSlack = 20000000ull;
+static constexpr uint64_t kSlackMargin  = 50000ull;
+
+static constexpr int kSlackHistory   = 16;
+static constexpr int kPredictHistory = 32;
+static constexpr int kStatHistory    = 256;
+
+static uint64_t oversleep_history[kSlackHistory];
+static int      oversleep_pos = 0;
+static uint64_t timer_slack   = 1000000ull;
+
+static uint64_t work_history[kPredictHistory];
+static int      work_count = 0;
+static int      work_pos   = 0;
+
+static uint64_t frame_history[kStatHistory];
+static int      frame_count = 0;
+static int      frame_pos   = 0;
+
+static uint64_t next_deadline = 0;
+static uint64_t last_present  = 0;
+static uint64_t frame_start   = 0;
+static bool     latch_pending = false;
+
+uint64_t PacingGetNanoseconds(void)
+{
+#ifdef __linux__
+    // same clock as clock_nanosleep() below, so deadlines can be absolute
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * kNanosecondsPerSecond + (uint64_t)ts.tv_nsec;
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+#endif
+}
+
+// Coarse OS sleep until `target`.  May wake late by up to the timer slack.
+static void SleepSystem(uint64_t target, uint64_t now)
+{
+#ifdef __linux__
+    EPI_UNUSED(now);
+
+    struct timespec ts;
+    ts.tv_sec  = (time_t)(target / kNanosecondsPerSecond);
+    ts.tv_nsec = (long)(target % kNanosecondsPerSecond);
+
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+    {
+    }
+#else
+#if !defined(__MINGW32__) && (defined(WIN32) || defined(_WIN32) || defined(_WIN64))
+    if (windows_timer != nullptr)
+    {
+        LARGE_INTEGER due_time;
+        due_time.QuadPart = -(LONGLONG)((target - now) / 100);
+        if (SetWaitableTimerEx(windows_timer, &due_time, 0, nullptr, nullptr, nullptr, 0))
+        {
+            WaitForSingleObject(windows_timer, INFINITE);
+            return;
+        }
+    }
+#endif
+    SDL_Delay((uint32_t)((target - now) / 1000000ull));
+#endif
+}
+
+static void UpdateTimerSlack(uint64_t oversleep)
+{
+    oversleep_history[oversleep_pos] = oversleep;
+    oversleep_pos                    = (oversleep_pos + 1) % kSlackHistory;
+
+    uint64_t worst = 0;
+    for (int i = 0; i < kSlackHistory; i++)
+        worst = std::max(worst, oversleep_history[i]);
+
+    timer_slack = std::clamp(worst + kSlackMargin, kMinimumSlack, kMaximumSlack);
+}
+
+void PacingSleepUntil(uint64_t deadline)
+{
+    uint64_t now = PacingGetNanoseconds();
+
+    if (now >= deadline)
+        return;
+
+    if (deadline - now > timer_slack)
+    {
+        uint64_t target = deadline - timer_slack;
+
+        SleepSystem(target, now);
+
+        now = PacingGetNanoseconds();
+        UpdateTimerSlack(now > target ? now - target : 0);
+    }
+
+    while (now < deadline)
+    {
+        std::this_thread::yield();
+        now = PacingGetNanoseconds();
+    }
+}
+
+// Time from the latch to the next present (running the tics, rendering),
+// taken as mean + 2 standard deviations of the recent history so that an
+// ordinary spike still makes the deadline.
+static uint64_t PredictWorkTime(void)
+{
+    if (work_count == 0)
+        return 0;
+
+    double mean = 0;
+    for (int i = 0; i < work_count; i++)
+        mean += (double)work_history[i];
+    mean /= work_count;
+
+    double variance = 0;
+    for (int i = 0; i < work_count; i++)
+    {
+        double d = (double)work_history[i] - mean;
+        variance += d * d;
+    }
+    variance /= work_count;
+
+    return (uint64_t)(mean + 2.0 * sqrt(variance));
+}
+
+void PacingFinishFrame(int framerate_limit)
+{
+    uint64_t now = PacingGetNanoseconds();
+
+    if (last_present != 0)
+    {
+        frame_history[frame_pos] = now - last_present;
+        frame_pos                = (frame_pos + 1) % kStatHistory;
+        frame_count              = std::min(frame_count + 1, kStatHistory);
+    }
+    if (frame_start != 0)
+    {
+        work_history[work_pos] = now - frame_start;
+        work_pos               = (work_pos + 1) % kPredictHistory;
+        work_count             = std::min(work_count + 1, kPredictHistory);
+    }
+
+    last_present  = now;
+    frame_start   = now;
+    latch_pending = false;
+
+    if (framerate_limit <= 0)
+    {
+        next_deadline = 0;
+        return;
+    }
+
+    uint64_t interval = kNanosecondsPerSecond / framerate_limit;
+
+    // keep a steady cadence, but don't try to catch up after a hitch
+    if (next_deadline == 0 || now > next_deadline + interval)
+        next_deadline = now + interval;
+    else
+        next_deadline += interval;
+
+    if (late_latching.d_)
+    {
+        latch_pending = true;
+        return;
+    }
+
+    PacingSleepUntil(next_deadline);
+    frame_start = PacingGetNanoseconds();
+}
+
+void PacingBeforeInput(void)
+{
+    if (!latch_pending)
+        return;
+
+    latch_pending = false;
+
+    uint64_t interval = next_deadline - last_present;
+    uint64_t predict  = std::min(PredictWorkTime(), interval);
+
+    PacingSleepUntil(next_deadline - predict);
+    frame_start = PacingGetNanoseconds();
+}
+
+void PacingPrintStats(void)
+{
+    if (frame_count == 0)
+    {
+        LogPrint("No frames recorded yet.\n");
+        return;
+    }
+
+    std::vector<uint64_t> sorted(frame_history, frame_history + frame_count);
+    std::sort(sorted.begin(), sorted.end());
+
+    double mean = 0;
+    for (uint64_t t : sorted)
+        mean += (double)t;
+    mean /= frame_count;
+
+    double variance = 0;
+    for (uint64_t t : sorted)
+    {
+        double d = (double)t - mean;
+        variance += d * d;
+    }
+    variance /= frame_count;
+
+    uint64_t p99 = sorted[std::min(frame_count - 1, frame_count * 99 / 100)];
+
+    LogPrint("Frame times over last %d frames:\n", frame_count);
+    LogPrint("  mean %.3f ms (%.1f fps)  stddev %.3f ms\n", mean / 1e6, mean > 0 ? 1e9 / mean : 0.0,
+             sqrt(variance) / 1e6);
+    LogPrint("  min %.3f ms  max %.3f ms  99th %.3f ms\n", sorted.front() / 1e6, sorted.back() / 1e6, p99 / 1e6);
+    LogPrint("  predicted work %.3f ms  timer slack %.3f ms  late latching %s\n", PredictWorkTime() / 1e6,
+             timer_slack / 1e6, late_latching.d_ ? "on" : "off");
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
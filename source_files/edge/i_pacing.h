@@ -0,0 +1,46 @@
+//----------------------------------------------------------------------------
+//  EDGE Frame Pacing
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+
+// Monotonic clock in nanoseconds (arbitrary epoch).
+uint64_t PacingGetNanoseconds(void);
+
+// Sleeps until the given PacingGetNanoseconds() time.  The OS sleep is
+// stopped short by the measured timer slack and only that last sliver is
+// spun, so waits are precise without burning a core.
+void PacingSleepUntil(uint64_t deadline);
+
+// Called by FinishFrame() right after the buffer swap.  Records frame
+// statistics and, unless late latching is in effect, waits for the next
+// frame slot.  A limit of zero means "uncapped".
+void PacingFinishFrame(int framerate_limit);
+
+// Called by TryRunTicCommands() before input is read and the tic
+// commands are built.  With late latching this is where the frame-slot
+// wait happens instead, waking just early enough to run the tics and
+// render the frame (predicted from recent frames) so that the input
+// sampled afterwards is as fresh as possible.
+void PacingBeforeInput(void);
+
+void PacingPrintStats(void);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -66,7 +66,12 @@ void StartupAudio(void)
     if (no_sound)
         return;
 
-    if (ma_engine_init(NULL, &sound_engine) != MA_SUCCESS)
+    // sound effect commands from the game thread are applied between
+    // mixing buffers, on the audio thread.
+    ma_engine_config engine_config = ma_engine_config_init();
+    engine_config.onProcess        = ProcessSoundCommands;
+
+    if (ma_engine_init(&engine_config, &sound_engine) != MA_SUCCESS)
     {
         LogPrint("StartupSound: Unable to initialize sound engine!\n");
         no_sound = true;
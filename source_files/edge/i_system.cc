@@ -23,11 +23,13 @@
 
 #include "con_main.h"
 #include "dm_defs.h"
+#include "dm_state.h"
 #include "e_main.h"
 #include "epi.h"
 #include "epi_sdl.h"
 #include "epi_windows.h"
 #include "g_game.h"
+#include "i_pacing.h"
 #include "m_argv.h"
 #include "m_menu.h"
 #include "m_misc.h"
@@ -39,10 +41,6 @@
 extern FILE *debug_file;
 extern FILE *log_file;
 
-#if !defined(__MINGW32__) && (defined(WIN32) || defined(_WIN32) || defined(_WIN64))
-extern HANDLE windows_timer;
-#endif
-
 // output string buffer
 static constexpr int16_t kMessageBufferSize = 4096;
 static char              message_buffer[kMessageBufferSize];
@@ -130,6 +128,12 @@ void LogPrint(const char *message, ...)
 
 void ShowMessageBox(const char *message, const char *title)
 {
+    if (headless_mode)
+    {
+        fprintf(stderr, "%s: %s\n", title, message);
+        return;
+    }
+
     SDL_ShowSimpleMessageBox(SDL_MESSAGEBOX_ERROR, title, message, nullptr);
 }
 
@@ -150,22 +154,7 @@ uint32_t GetMicroseconds(void)
 
 void SleepForMilliseconds(int millisecs)
 {
-#if !defined(__MINGW32__) && (defined(WIN32) || defined(_WIN32) || defined(_WIN64))
-    // On Windows use high resolution timer if available, the Sleep Win32 call
-    // defaults to 15.6ms resolution and timeBeginPeriod is problematic
-    if (windows_timer != nullptr)
-    {
-        LARGE_INTEGER due_time;
-        due_time.QuadPart = -((LONGLONG)(millisecs * 1000000) / 100);
-        if (SetWaitableTimerEx(windows_timer, &due_time, 0, nullptr, nullptr, nullptr, 0))
-        {
-            WaitForSingleObject(windows_timer, INFINITE);
-        }
-        return;
-    }
-#endif
-
-    SDL_Delay(millisecs);
+    PacingSleepUntil(PacingGetNanoseconds() + (uint64_t)millisecs * 1000000ull);
 }
 
 void SystemShutdown(void)
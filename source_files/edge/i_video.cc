@@ -24,9 +24,11 @@
 #include "epi_str_compare.h"
 #include "epi_str_util.h"
 #include "i_defs_gl.h"
+#include "i_pacing.h"
 #include "i_system.h"
 #include "m_argv.h"
 #include "m_misc.h"
+#include "m_profile.h"
 #include "n_network.h"
 #include "r_backend.h"
 #include "r_modes.h"
@@ -422,6 +424,8 @@ static void SwapBuffers(void)
 
 void FinishFrame(void)
 {
+    EDGE_PROFILE_SCOPE("FinishFrame");
+
     render_backend->FinishFrame();
 
     SwapBuffers();
@@ -436,34 +440,7 @@ void FinishFrame(void)
             GrabCursor(true);
     }
 
-    if (!single_tics)
-    {
-        if (framerate_limit.d_ >= kTicRate)
-        {
-            uint64_t        target_time = 1000000ull / framerate_limit.d_;
-            static uint64_t start_time;
-
-            while (1)
-            {
-                uint64_t current_time   = GetMicroseconds();
-                uint64_t elapsed_time   = current_time - start_time;
-                uint64_t remaining_time = 0;
-
-                if (elapsed_time >= target_time)
-                {
-                    start_time = current_time;
-                    break;
-                }
-
-                remaining_time = target_time - elapsed_time;
-
-                if (remaining_time > 1000)
-                {
-                    SleepForMilliseconds((remaining_time - 1000) / 1000);
-                }
-            }
-        }
-    }
+    PacingFinishFrame((!single_tics && framerate_limit.d_ >= kTicRate) ? framerate_limit.d_ : 0);
 
     fractional_tic = (float)(GetMilliseconds() * kTicRate % 1000) / 1000;
 
@@ -494,7 +471,7 @@ void FinishFrame(void)
 
 void ShutdownGraphics(void)
 {
-    if (graphics_shutdown)
+    if (graphics_shutdown || headless_mode)
         return;
 
     graphics_shutdown = 1;
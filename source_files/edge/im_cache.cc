@@ -0,0 +1,229 @@
+//----------------------------------------------------------------------------
+//  EDGE Processed Image Disk Cache
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "im_cache.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+#include "epi.h"
+#include "epi_filesystem.h"
+#include "epi_str_util.h"
+
+// bump this whenever the file layout (or the processing which feeds
+// it) changes in an incompatible way
+static constexpr uint32_t kImageCacheVersion = 1;
+
+static constexpr char kImageCacheMagic[4] = {'E', 'I', 'M', 'C'};
+
+struct ImageCacheHeader
+{
+    char           magic[4];
+    uint32_t       version;
+    int32_t        width;
+    int32_t        height;
+    int32_t        depth;
+    ImageCacheInfo info;
+};
+
+static std::string cache_folder;
+
+static size_t              cache_budget = 0;
+static std::atomic<size_t> cache_used{0};
+
+// identical sources with identical settings share a key, so every save
+// writes to its own temporary file before the rename
+static std::atomic<uint32_t> temp_serial{0};
+
+// Deletes leftover temporary files, then the oldest entries until the
+// folder is within three quarters of the budget, leaving room for new
+// entries this run.
+static void TrimCacheFolder(void)
+{
+    std::vector<epi::DirectoryEntry> entries;
+
+    if (epi::ReadDirectory(entries, cache_folder, "*.tmp"))
+    {
+        for (const epi::DirectoryEntry &entry : entries)
+        {
+            if (!entry.is_dir)
+                epi::FileDelete(entry.name);
+        }
+    }
+
+    size_t total = 0;
+
+    if (!epi::ReadDirectory(entries, cache_folder, "*.eic"))
+    {
+        cache_used = 0;
+        return;
+    }
+
+    for (const epi::DirectoryEntry &entry : entries)
+        total += entry.size;
+
+    if (total > cache_budget)
+    {
+        std::sort(entries.begin(), entries.end(),
+                  [](const epi::DirectoryEntry &A, const epi::DirectoryEntry &B) { return A.modified < B.modified; });
+
+        size_t target = cache_budget / 4 * 3;
+
+        for (const epi::DirectoryEntry &entry : entries)
+        {
+            if (total <= target)
+                break;
+
+            if (!entry.is_dir && epi::FileDelete(entry.name))
+                total -= entry.size;
+        }
+    }
+
+    cache_used = total;
+}
+
+void ImageDiskCacheInit(const std::string &directory, size_t budget)
+{
+    cache_folder.clear();
+
+    if (directory.empty())
+        return;
+
+    if (!epi::IsDirectory(directory) && !epi::MakeDirectory(directory))
+    {
+        LogWarning("Unable to create image cache folder: %s\n", directory.c_str());
+        return;
+    }
+
+    cache_folder = directory;
+    cache_budget = budget;
+
+    TrimCacheFolder();
+}
+
+bool ImageDiskCacheEnabled(void)
+{
+    return !cache_folder.empty();
+}
+
+static std::string CacheFilename(const std::string &key)
+{
+    return epi::PathAppend(cache_folder, key + ".eic");
+}
+
+ImageData *ImageDiskCacheLoad(const std::string &key, ImageCacheInfo *info)
+{
+    if (cache_folder.empty())
+        return nullptr;
+
+    FILE *fp = epi::FileOpenRaw(CacheFilename(key), epi::kFileAccessRead | epi::kFileAccessBinary);
+
+    if (!fp)
+        return nullptr;
+
+    ImageCacheHeader header;
+
+    if (fread(&header, sizeof(header), 1, fp) != 1 || memcmp(header.magic, kImageCacheMagic, 4) != 0 ||
+        header.version != kImageCacheVersion || header.width <= 0 || header.height <= 0 ||
+        (header.depth != 3 && header.depth != 4))
+    {
+        fclose(fp);
+        return nullptr;
+    }
+
+    ImageData *img = new ImageData(header.width, header.height, header.depth);
+
+    size_t total = (size_t)header.width * header.height * header.depth;
+
+    // the pixels go straight into the image in one read
+    bool ok = (fread(img->pixels_, 1, total, fp) == total);
+
+    fclose(fp);
+
+    if (!ok)
+    {
+        delete img;
+        return nullptr;
+    }
+
+    *info = header.info;
+
+    return img;
+}
+
+void ImageDiskCacheSave(const std::string &key, const ImageData *img, const ImageCacheInfo &info)
+{
+    if (cache_folder.empty())
+        return;
+
+    EPI_ASSERT(img->depth_ == 3 || img->depth_ == 4);
+
+    size_t total = (size_t)img->width_ * img->height_ * img->depth_;
+
+    // reserve the space first, as other threads may be saving too
+    size_t entry_size = sizeof(ImageCacheHeader) + total;
+
+    if (cache_used.fetch_add(entry_size) + entry_size > cache_budget)
+    {
+        cache_used -= entry_size;
+        return;
+    }
+
+    std::string filename  = CacheFilename(key);
+    std::string temp_name =
+        epi::PathAppend(cache_folder, epi::StringFormat("%s.%u.tmp", key.c_str(), (unsigned)temp_serial.fetch_add(1)));
+
+    FILE *fp = epi::FileOpenRaw(temp_name, epi::kFileAccessWrite | epi::kFileAccessBinary);
+
+    if (!fp)
+    {
+        cache_used -= entry_size;
+        return;
+    }
+
+    ImageCacheHeader header;
+
+    EPI_CLEAR_MEMORY(&header, ImageCacheHeader, 1);
+
+    memcpy(header.magic, kImageCacheMagic, 4);
+
+    header.version = kImageCacheVersion;
+    header.width   = img->width_;
+    header.height  = img->height_;
+    header.depth   = img->depth_;
+    header.info    = info;
+
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1) && (fwrite(img->pixels_, 1, total, fp) == total);
+
+    if (fclose(fp) != 0)
+        ok = false;
+
+    // don't leave a truncated entry behind
+    if (!ok || !epi::FileRename(temp_name, filename))
+    {
+        epi::FileDelete(temp_name);
+        cache_used -= entry_size;
+    }
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
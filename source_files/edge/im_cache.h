@@ -0,0 +1,63 @@
+//----------------------------------------------------------------------------
+//  EDGE Processed Image Disk Cache
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  Stores images after all decoding and filtering (HQ2x, blur, shrink
+//  to texture limits) has been done, so later runs can skip straight to
+//  the texture upload.  Entries are keyed by a hash of the source data
+//  plus every setting which affects the result, so stale entries are
+//  never hit, merely left unused.  The folder is kept within a size
+//  budget: the oldest entries are deleted at startup, and no new ones
+//  are written once it is full.  Entries are written to a temporary
+//  file and renamed into place, so a crash never leaves a partial one.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <string>
+
+#include "im_data.h"
+
+// properties of the source image which are determined while processing
+// it, and must be restored along with the pixels
+struct ImageCacheInfo
+{
+    int32_t  opacity;
+    uint16_t real_bottom;
+    uint16_t real_top;
+    uint16_t real_left;
+    uint16_t real_right;
+    uint8_t  is_empty;
+};
+
+// sets the folder to use, creating it if necessary, and trims it to
+// 'budget' bytes.  An empty string disables the cache.
+void ImageDiskCacheInit(const std::string &directory, size_t budget);
+
+bool ImageDiskCacheEnabled(void);
+
+// both of these are safe to call from worker threads, even with the same
+// key: each save writes its own temporary file, and the last rename wins.
+
+// returns nullptr when there is no (valid) entry for the key
+ImageData *ImageDiskCacheLoad(const std::string &key, ImageCacheInfo *info);
+
+void ImageDiskCacheSave(const std::string &key, const ImageData *img, const ImageCacheInfo &info);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
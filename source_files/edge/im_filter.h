@@ -40,17 +40,37 @@
 
 ImageData *ImageBlur(ImageData *image, float sigma);
 
-void HQ2xPaletteSetup(const uint8_t *palette, int transparent_pixel);
+// set at startup when the CPU has AVX2, which ImageBlur() then uses.
+// Can be cleared to compare against the SSE2 path (-benchmark filters).
+extern bool image_filter_avx2;
+
+// Look-up tables for HQ2x, built from a palette by HQ2xPaletteSetup().
+// Images may be scaled on several threads at once, so each of them
+// needs its own set.
+struct HQ2xPalette
+{
+    uint32_t pixel_rgb[256];
+    uint32_t pixel_yuv[256];
+
+    // One bit per pair of palette indices, set when the two colours
+    // differ enough (in YUV space) to count as an edge.
+    uint8_t yuv_diff[256][32];
+
+    // the palette which the tables were last built for
+    uint8_t last_palette[256 * 3];
+    int     last_transparent_pixel = -2;
+};
+
+void HQ2xPaletteSetup(HQ2xPalette *tables, const uint8_t *palette, int transparent_pixel);
 // initialises look-up tables based on the given palette.
 // The 'trans_pixel' gives a pixel index which is fully
 // transparent, or none when -1.
 
-ImageData *ImageHQ2x(ImageData *image, bool solid, bool invert = false);
+ImageData *ImageHQ2x(const HQ2xPalette *tables, ImageData *image, bool solid, bool invert = false);
 // converts a single palettised image into an RGB or RGBA
-// image (depending on the solid parameter).  The Setup()
-// method must be called sometime prior to calling this
-// function, and this determines the palette of the input
-// image.
+// image (depending on the solid parameter).  The tables
+// must have been set up with the palette of the input
+// image by HQ2xPaletteSetup().
 
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
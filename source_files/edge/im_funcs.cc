@@ -136,14 +136,26 @@ ImageFormat ImageFormatFromFilename(const std::string &filename)
 }
 
 ImageData *LoadImageData(epi::File *file)
+{
+    int      length    = file->GetLength();
+    uint8_t *raw_image = file->LoadIntoMemory();
+
+    if (!raw_image)
+        return nullptr;
+
+    ImageData *img = LoadImageData(raw_image, length);
+
+    delete[] raw_image;
+
+    return img;
+}
+
+ImageData *LoadImageData(const uint8_t *raw_image, int length)
 {
     int width  = 0;
     int height = 0;
     int depth  = 0;
 
-    int      length    = file->GetLength();
-    uint8_t *raw_image = file->LoadIntoMemory();
-
     uint8_t *decoded_img = stbi_load_from_memory(raw_image, length, &width, &height, &depth, 0);
 
     // we don't want no grayscale here, force STB to convert
@@ -160,8 +172,6 @@ ImageData *LoadImageData(epi::File *file)
         depth = new_depth; // sigh...
     }
 
-    delete[] raw_image;
-
     if (decoded_img == nullptr)
         return nullptr;
 
@@ -76,6 +76,11 @@ ImageFormat ImageFormatFromFilename(const std::string &filename);
 // rounded to the next power-of-two.
 ImageData *LoadImageData(epi::File *file);
 
+// as above, but decodes an image which is already in memory.
+// Does not touch any global state, so it is safe to call from
+// a worker thread.
+ImageData *LoadImageData(const uint8_t *raw_image, int length);
+
 // given a collection of loaded images, pack and return the image data
 // for an atlas containing all of them. Does not assume that the incoming
 // data pointers should be deleted/freed. Images at a BPP of 3 will be
@@ -25,15 +25,165 @@
 
 #include "l_deh.h"
 
+#include <stdio.h>
+#include <string.h>
+
 #include "con_var.h"
 #include "ddf_main.h"
 #include "deh_edge.h"
+#include "dm_state.h"
+#include "epi_filesystem.h"
+#include "epi_md5.h"
+#include "epi_str_util.h"
 #include "i_system.h"
+#include "version.h"
 
 EDGE_DEFINE_CONSOLE_VARIABLE(debug_dehacked, "0", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(dehacked_cache, "1", kConsoleVariableFlagArchive)
+
+//
+// Converted patches are cached on disk, keyed by the MD5 of the patch
+// itself plus the engine version, since the conversion depends on
+// nothing else.  Each cache file holds the DDF (and RTS) text produced
+// by the converter, so a hit skips the whole DeHackEd parse.  Parsing
+// that text is cached along with all other DDF by DDFParseEverything().
+//
+
+// the engine version covers converter changes between releases; bump
+// this as well when the output changes in between (dev builds)
+static constexpr uint32_t kDehackedCacheVersion = 1;
+
+static constexpr char kDehackedCacheMagic[4] = {'E', 'D', 'H', 'C'};
+
+struct DehackedCacheHeader
+{
+    char     magic[4];
+    uint32_t version;
+    uint32_t length; // of the original patch
+    uint32_t count;  // number of DDFFile entries which follow
+};
+
+static std::string DehackedCacheFilename(const uint8_t *data, int length)
+{
+    epi::MD5Hash md5((const uint8_t *)data, length);
+
+    std::string key =
+        epi::StringFormat("%s:%s:%u", md5.ToString().c_str(), edge_version.c_str(), kDehackedCacheVersion);
+
+    epi::MD5Hash key_md5((const uint8_t *)key.data(), (unsigned int)key.size());
+
+    return epi::PathAppend(cache_directory, "deh-" + key_md5.ToString() + ".edc");
+}
+
+static bool DehackedCacheLoad(const std::string &filename, int length, std::vector<DDFFile> &col)
+{
+    FILE *fp = epi::FileOpenRaw(filename, epi::kFileAccessRead | epi::kFileAccessBinary);
+
+    if (!fp)
+        return false;
+
+    DehackedCacheHeader header;
+
+    bool ok = (fread(&header, sizeof(header), 1, fp) == 1) && memcmp(header.magic, kDehackedCacheMagic, 4) == 0 &&
+              header.version == kDehackedCacheVersion && header.length == (uint32_t)length;
+
+    for (uint32_t i = 0; ok && i < header.count; i++)
+    {
+        int32_t  type;
+        uint32_t size;
+
+        if (fread(&type, sizeof(type), 1, fp) != 1 || fread(&size, sizeof(size), 1, fp) != 1 ||
+            type <= kDDFTypeUnknown || type >= kTotalDDFTypes)
+        {
+            ok = false;
+            break;
+        }
+
+        DDFFile file;
+
+        file.type = (DDFType)type;
+        file.data.resize(size);
+
+        if (size > 0 && fread(&file.data[0], 1, size, fp) != size)
+        {
+            ok = false;
+            break;
+        }
+
+        col.push_back(std::move(file));
+    }
+
+    fclose(fp);
+
+    if (!ok)
+        col.clear();
+
+    return ok;
+}
+
+static void DehackedCacheSave(const std::string &filename, int length, const std::vector<DDFFile> &col)
+{
+    std::string temp_name = filename + ".tmp";
+
+    FILE *fp = epi::FileOpenRaw(temp_name, epi::kFileAccessWrite | epi::kFileAccessBinary);
+
+    if (!fp)
+        return;
+
+    DehackedCacheHeader header;
+
+    EPI_CLEAR_MEMORY(&header, DehackedCacheHeader, 1);
+
+    memcpy(header.magic, kDehackedCacheMagic, 4);
+
+    header.version = kDehackedCacheVersion;
+    header.length  = (uint32_t)length;
+    header.count   = (uint32_t)col.size();
+
+    bool ok = (fwrite(&header, sizeof(header), 1, fp) == 1);
+
+    for (const DDFFile &file : col)
+    {
+        if (!ok)
+            break;
+
+        int32_t  type = (int32_t)file.type;
+        uint32_t size = (uint32_t)file.data.size();
+
+        ok = (fwrite(&type, sizeof(type), 1, fp) == 1) && (fwrite(&size, sizeof(size), 1, fp) == 1) &&
+             (size == 0 || fwrite(file.data.data(), 1, size, fp) == size);
+    }
+
+    if (fclose(fp) != 0)
+        ok = false;
+
+    // written aside and renamed, so a truncated entry is never seen
+    if (!ok || !epi::FileRename(temp_name, filename))
+        epi::FileDelete(temp_name);
+}
 
 void ConvertDehacked(const uint8_t *data, int length, const std::string &source)
 {
+    std::string cache_file;
+
+    if (dehacked_cache.d_ && !cache_directory.empty())
+    {
+        cache_file = DehackedCacheFilename(data, length);
+
+        std::vector<DDFFile> col;
+
+        if (DehackedCacheLoad(cache_file, length, col))
+        {
+            LogDebug("Dehacked: using cached conversion %s\n", cache_file.c_str());
+
+            if (debug_dehacked.d_ > 0)
+                DDFDumpCollection(col);
+
+            DDFAddCollection(col, source);
+            return;
+        }
+    }
+
     DehackedStartup();
 
     DehackedResult ret = DehackedAddLump((const char *)data, length);
@@ -62,6 +212,10 @@ void ConvertDehacked(const uint8_t *data, int length, const std::string &source)
     if (debug_dehacked.d_ > 0)
         DDFDumpCollection(col);
 
+    // before DDFAddCollection(), which may consume the text
+    if (!cache_file.empty())
+        DehackedCacheSave(cache_file, length, col);
+
     DDFAddCollection(col, source);
 }
 
@@ -0,0 +1,211 @@
+//----------------------------------------------------------------------------
+//  EDGE Frame/Tic Profiler
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "m_profile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include <vector>
+
+#include "HandmadeMath.h"
+#include "con_var.h"
+#include "dm_state.h"
+#include "epi.h"
+#include "epi_filesystem.h"
+#include "epi_str_util.h"
+
+extern ConsoleVariable debug_profile;
+
+bool profiler_active = false;
+int  profile_depth   = 0;
+
+thread_local bool profile_main_thread = false;
+
+// zones are registered when first recorded, which is always on the main
+// thread (a zone may be constructed on another thread, but never records)
+static std::vector<ProfileZone *> profile_zones;
+
+static int      history_position = 0;
+static uint32_t last_refresh     = 0;
+static int      refresh_frames   = 0;
+
+struct ProfileEvent
+{
+    const ProfileZone *zone;
+    uint32_t           start;
+    uint32_t           duration;
+};
+
+static std::vector<ProfileEvent> capture_events;
+static int                       capture_frames = 0;
+static uint32_t                  capture_start  = 0;
+
+static constexpr size_t kMaximumCaptureEvents = 4 * 1024 * 1024;
+
+ProfileZone::ProfileZone(const char *name)
+    : name_(name), depth_(0), frame_time_(0), frame_calls_(0), refresh_calls_(0), shown_average_(0), shown_worst_(0),
+      shown_calls_(0), registered_(false)
+{
+    memset(history_, 0, sizeof(history_));
+}
+
+void ProfileRecord(ProfileZone *zone, uint32_t start, uint32_t finish)
+{
+    EPI_ASSERT(profile_main_thread);
+
+    if (!zone->registered_)
+    {
+        zone->registered_ = true;
+        profile_zones.push_back(zone);
+    }
+
+    uint32_t duration = finish - start;
+
+    zone->depth_ = profile_depth;
+    zone->frame_time_ += duration;
+    zone->frame_calls_ += 1;
+
+    if (capture_frames > 0 && capture_events.size() < kMaximumCaptureEvents)
+        capture_events.push_back({zone, start, duration});
+}
+
+int ProfileZoneCount(void)
+{
+    return (int)profile_zones.size();
+}
+
+ProfileZone *ProfileGetZone(int index)
+{
+    EPI_ASSERT(index >= 0 && index < (int)profile_zones.size());
+
+    return profile_zones[index];
+}
+
+static void WriteCapture(void)
+{
+    std::string filename;
+
+    for (int i = 1; i <= 9999; i++)
+    {
+        filename = epi::PathAppend(home_directory, epi::StringFormat("profile%02d.json", i));
+
+        if (!epi::TestFileAccess(filename))
+            break;
+    }
+
+    FILE *fp = epi::FileOpenRaw(filename, epi::kFileAccessWrite | epi::kFileAccessBinary);
+
+    if (!fp)
+    {
+        LogWarning("Unable to write profile trace: %s\n", filename.c_str());
+        return;
+    }
+
+    fprintf(fp, "{\"traceEvents\":[\n");
+
+    for (size_t i = 0; i < capture_events.size(); i++)
+    {
+        const ProfileEvent &ev = capture_events[i];
+
+        // zone names are string literals, so need no escaping
+        fprintf(fp, "{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%u,\"dur\":%u}%s\n", ev.zone->name_,
+                ev.start - capture_start, ev.duration, (i + 1 < capture_events.size()) ? "," : "");
+    }
+
+    fprintf(fp, "],\"displayTimeUnit\":\"ms\"}\n");
+    fclose(fp);
+
+    LogPrint("Profile trace (%d events) written to: %s\n", (int)capture_events.size(), filename.c_str());
+}
+
+void ProfileStartCapture(int frames)
+{
+    capture_events.clear();
+    capture_frames = HMM_MAX(1, frames);
+    capture_start  = GetMicroseconds();
+}
+
+void ProfileStartFrame(void)
+{
+    profile_main_thread = true;
+
+#ifdef EDGE_PROFILING
+    profiler_active = (debug_profile.d_ > 0) || (capture_frames > 0);
+#endif
+    profile_depth = 0;
+}
+
+void ProfileFinishFrame(void)
+{
+    if (!profiler_active)
+        return;
+
+    for (ProfileZone *zone : profile_zones)
+    {
+        zone->history_[history_position] = zone->frame_time_;
+        zone->refresh_calls_ += zone->frame_calls_;
+        zone->frame_time_  = 0;
+        zone->frame_calls_ = 0;
+    }
+
+    history_position = (history_position + 1) % kProfileHistory;
+    refresh_frames++;
+
+    // refresh the shown values once a second, so they can be read
+    uint32_t now = GetMicroseconds();
+
+    if (now - last_refresh > 1000000)
+    {
+        last_refresh = now;
+
+        for (ProfileZone *zone : profile_zones)
+        {
+            uint32_t total = 0;
+            uint32_t worst = 0;
+
+            for (int i = 0; i < kProfileHistory; i++)
+            {
+                total += zone->history_[i];
+                worst = HMM_MAX(worst, zone->history_[i]);
+            }
+
+            zone->shown_average_ = (float)total / (float)(kProfileHistory * 1000);
+            zone->shown_worst_   = (float)worst / 1000.0f;
+            zone->shown_calls_   = (float)zone->refresh_calls_ / (float)refresh_frames;
+            zone->refresh_calls_ = 0;
+        }
+
+        refresh_frames = 0;
+    }
+
+    if (capture_frames > 0)
+    {
+        capture_frames--;
+
+        if (capture_frames == 0)
+        {
+            WriteCapture();
+            capture_events.clear();
+            capture_events.shrink_to_fit();
+        }
+    }
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,126 @@
+//----------------------------------------------------------------------------
+//  EDGE Frame/Tic Profiler
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+//  Put EDGE_PROFILE_SCOPE("Name") at the top of a block to time it.
+//  Times are summed per frame and kept for the last kProfileHistory
+//  frames, shown by the 'debug_profile' overlay, and can be captured
+//  to a Chrome trace file (chrome://tracing, Perfetto) with the
+//  'profile_trace' console command.
+//
+//  Only the main thread records anything: a scope entered on any other
+//  thread (playsim thread, workers) does nothing.  When the profiler is
+//  idle a scope costs a single test of a global flag, and building
+//  without EDGE_PROFILING removes them completely.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <stdint.h>
+
+#include "i_system.h"
+
+constexpr int kProfileHistory = 128;
+
+class ProfileZone
+{
+  public:
+    const char *name_;
+
+    // nesting level when last entered, for the overlay
+    int depth_;
+
+    // this frame
+    uint32_t frame_time_;
+    int      frame_calls_;
+
+    // calls since the shown values were last updated
+    int refresh_calls_;
+
+    // per-frame totals (microseconds), oldest overwritten first
+    uint32_t history_[kProfileHistory];
+
+    // values shown by the overlay, updated about once a second
+    float shown_average_;
+    float shown_worst_;
+    float shown_calls_; // per frame
+
+    // added to the zone list on its first record
+    bool registered_;
+
+    ProfileZone(const char *name);
+};
+
+extern bool profiler_active;
+extern int  profile_depth;
+
+// only set on the thread which calls ProfileStartFrame()
+extern thread_local bool profile_main_thread;
+
+void ProfileRecord(ProfileZone *zone, uint32_t start, uint32_t finish);
+
+class ProfileScope
+{
+  private:
+    ProfileZone *zone_;
+    uint32_t     start_;
+
+  public:
+    ProfileScope(ProfileZone *zone) : zone_(nullptr), start_(0)
+    {
+        if (profiler_active && profile_main_thread)
+        {
+            zone_  = zone;
+            start_ = GetMicroseconds();
+            profile_depth++;
+        }
+    }
+
+    ~ProfileScope()
+    {
+        if (zone_)
+        {
+            profile_depth--;
+            ProfileRecord(zone_, start_, GetMicroseconds());
+        }
+    }
+};
+
+#ifdef EDGE_PROFILING
+#define EDGE_PROFILE_CONCAT2(a, b) a##b
+#define EDGE_PROFILE_CONCAT(a, b)  EDGE_PROFILE_CONCAT2(a, b)
+#define EDGE_PROFILE_SCOPE(name)                                                                                       \
+    static ProfileZone EDGE_PROFILE_CONCAT(profile_zone_, __LINE__)(name);                                             \
+    ProfileScope       EDGE_PROFILE_CONCAT(profile_scope_, __LINE__)(&EDGE_PROFILE_CONCAT(profile_zone_, __LINE__))
+#else
+#define EDGE_PROFILE_SCOPE(name)
+#endif
+
+// call once at the start and end of every pass through the main loop
+void ProfileStartFrame(void);
+void ProfileFinishFrame(void);
+
+// records every scope for the next 'frames' frames, then writes them
+// as a Chrome trace into the home directory.
+void ProfileStartCapture(int frames);
+
+int          ProfileZoneCount(void);
+ProfileZone *ProfileGetZone(int index);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -32,6 +32,7 @@
 #include "epi_str_util.h"
 #include "epi_windows.h"
 #include "g_game.h"
+#include "i_pacing.h"
 #include "i_system.h"
 #include "m_argv.h"
 #include "m_random.h"
@@ -39,13 +40,13 @@
 #include "vm_coal.h"
 
 extern coal::VM *ui_vm;
-extern void      COALSetFloat(coal::VM *vm, const char *mod_name, const char *var_name, double value);
 
 // only true if packets are exchanged with a server
 bool network_game = false;
 
-EDGE_DEFINE_CONSOLE_VARIABLE(busy_wait, "1",
-                             kConsoleVariableFlagReadOnly) // Not sure what to rename this yet - Dasho
+// spin instead of sleeping while waiting for tics.  Sleeps are precise
+// (see i_pacing.cc) so this is only useful on very coarse system timers.
+EDGE_DEFINE_CONSOLE_VARIABLE(busy_wait, "0", kConsoleVariableFlagArchive)
 
 #if !defined(__MINGW32__) && (defined(WIN32) || defined(_WIN32) || defined(_WIN64))
 HANDLE windows_timer = nullptr;
@@ -79,10 +80,6 @@ void NetworkInitialize(void)
 
 #if !defined(__MINGW32__) && (defined(WIN32) || defined(_WIN32) || defined(_WIN64))
     windows_timer = CreateWaitableTimerExW(nullptr, nullptr, CREATE_WAITABLE_TIMER_HIGH_RESOLUTION, TIMER_ALL_ACCESS);
-    if (windows_timer != nullptr)
-    {
-        busy_wait = 0;
-    }
 #endif
 }
 
@@ -109,7 +106,7 @@ static void PostInput()
     UpdateKeyState();
 }
 
-static bool NetworkBuildTicCommands(void)
+bool NetworkBuildTicCommands(void)
 {
     // create player (and robot) ticcmds.
     // returns false if players cannot hold any more ticcmds.
@@ -168,7 +165,7 @@ void GrabTicCommands(void)
     if (LuaUseLuaHUD())
         LuaSetFloat(LuaGetGlobalVM(), "sys", "gametic", game_tic);
     else
-        COALSetFloat(ui_vm, "sys", "gametic", game_tic);
+        COALSetFloat(ui_vm, coal_sys_gametic, game_tic);
 
     game_tic++;
 }
@@ -208,6 +205,10 @@ int NetworkUpdate()
 
 int TryRunTicCommands()
 {
+    // with late latching, the frame-slot wait happens here so the input
+    // read for the new tic commands is as fresh as possible
+    PacingBeforeInput();
+
     if (single_tics)
     {
         PreInput();
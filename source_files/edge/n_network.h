@@ -39,5 +39,9 @@ void ResetTics(void);
 
 void GrabTicCommands(void);
 
+// build one ticcmd for each local player (bumps make_tic).  Returns
+// false if the buffers are full.
+bool NetworkBuildTicCommands(void);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
@@ -2956,11 +2956,8 @@ static void ObjectSpawning(MapObject *parent, BAMAngle angle)
 
     if (attack->spawn_limit_ > 0)
     {
-        int count = 0;
-        for (MapObject *mo = map_object_list_head; mo; mo = mo->next_)
-            if (mo->info_ == shoottype)
-                if (++count >= attack->spawn_limit_)
-                    return;
+        if (CountMapObjectsOfType(shoottype) >= attack->spawn_limit_)
+            return;
     }
 
     // -AJA- 1999/09/10: apply the angle offset of the attack.
@@ -4169,14 +4166,11 @@ void A_KeenDie(MapObject *mo)
     A_MakeIntoCorpse(mo);
 
     // see if all other Keens are dead
-    for (MapObject *cur = map_object_list_head; cur != nullptr; cur = cur->next_)
+    for (MapObject *cur = FirstMapObjectOfType(mo->info_); cur != nullptr; cur = cur->type_next_)
     {
         if (cur == mo)
             continue;
 
-        if (cur->info_ != mo->info_)
-            continue;
-
         if (cur->health_ > 0)
             return; // other Keen not dead
     }
@@ -4394,7 +4388,7 @@ void A_Become(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_ = become->info_;
+        SetMapObjectType(mo, become->info_);
 
         mo->morph_timeout_ = mo->info_->morphtimeout_;
 
@@ -4473,7 +4467,7 @@ void A_UnBecome(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_ = preBecome;
+        SetMapObjectType(mo, preBecome);
 
         mo->morph_timeout_ = mo->info_->morphtimeout_;
 
@@ -4555,7 +4549,7 @@ void A_Morph(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_   = morph->info_;
+        SetMapObjectType(mo, morph->info_);
         mo->health_ = mo->info_->spawn_health_; // Set health to full again
 
         mo->morph_timeout_ = mo->info_->morphtimeout_;
@@ -4635,7 +4629,7 @@ void A_UnMorph(MapObject *mo)
 
     UnsetThingPosition(mo);
     {
-        mo->info_ = preBecome;
+        SetMapObjectType(mo, preBecome);
 
         mo->health_ = mo->info_->spawn_health_; // Set health to max again
 
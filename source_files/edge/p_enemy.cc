@@ -32,6 +32,8 @@
 
 #include <float.h>
 
+#include <vector>
+
 #include "AlmostEquals.h"
 #include "dm_state.h"
 #include "epi.h"
@@ -64,20 +66,297 @@ float yspeed[8] = {0.0f, 0.7071067812f, 1.0f, 0.7071067812f, 0.0f, -0.7071067812
 //
 
 //
-// Called by NoiseAlert.
-// Recursively traverse adjacent sectors,
-// sound blocking lines cut off traversal.
+// Sound propagation graph.
+//
+// Each sector keeps the list of its neighbours across two-sided lines.
+// Every edge carries a copy of the line's sound-block flag and whether
+// the line is currently shut (closed door or closed sliding door), so
+// noise alerts never have to look at the lines themselves.  The graph
+// is built at level setup and individual edges are refreshed by
+// UpdateSoundGraphLine() whenever their line's gaps or slider change.
+//
+
+enum SoundEdgeFlag
+{
+    kSoundEdgeBlock  = (1 << 0), // line has kLineFlagSoundBlock
+    kSoundEdgeClosed = (1 << 1), // sound cannot pass at all
+};
+
+struct SoundEdge
+{
+    int     other; // sector index
+    uint8_t flags;
+};
+
+struct SoundFloodEntry
+{
+    int sector;
+    int soundblocks;
+};
+
+// edges of sector N are sound_edges[sound_edge_start[N] .. sound_edge_start[N+1]-1]
+static std::vector<int>       sound_edge_start;
+static std::vector<SoundEdge> sound_edges;
+
+// two edge indices per line (front sector side, back sector side), -1 if unused
+static std::vector<int> sound_line_edges;
+
+// bumped whenever an edge changes
+static int sound_graph_version = 0;
+
+// sectors reached by the last flood, replayed while the graph is unchanged
+static std::vector<SoundFloodEntry> sound_flood;
+static Sector                      *sound_flood_origin  = nullptr;
+static int                          sound_flood_version = -1;
+
+// sectors audible from the last listener sector: sector N is audible when
+// audible_stamp[N] == audible_current.
+static std::vector<int> audible_stamp;
+static int              audible_current = 0;
+static Sector          *audible_origin  = nullptr;
+static int              audible_version = -1;
+
+static uint8_t SoundEdgeFlagsForLine(const Line *ld)
+{
+    uint8_t flags = 0;
+
+    if (ld->flags & kLineFlagSoundBlock)
+        flags |= kSoundEdgeBlock;
+
+    if (!(ld->flags & kLineFlagTwoSided))
+        flags |= kSoundEdgeClosed;
+
+    // -AJA- 1999/07/19: Gaps are now stored in line_t.
+    if (ld->gap_number == 0)
+        flags |= kSoundEdgeClosed; // closed door
+
+    // -AJA- 2001/11/11: handle closed Sliding doors
+    if (ld->slide_door && !ld->slide_door->s_.see_through_ && !ld->slider_move)
+        flags |= kSoundEdgeClosed;
+
+    return flags;
+}
+
+void BuildSoundGraph(void)
+{
+    sound_edge_start.assign(total_level_sectors + 1, 0);
+    sound_edges.clear();
+    sound_line_edges.assign(total_level_lines * 2, -1);
+
+    for (int s = 0; s < total_level_sectors; s++)
+    {
+        Sector *sec = level_sectors + s;
+
+        sound_edge_start[s] = (int)sound_edges.size();
+
+        for (int i = 0; i < sec->line_count; i++)
+        {
+            Line *ld   = sec->lines[i];
+            int   side = (ld->front_sector == sec) ? 0 : 1;
+
+            Sector *other = side ? ld->front_sector : ld->back_sector;
+
+            if (!other || other == sec)
+                continue;
+
+            int slot = (int)(ld - level_lines) * 2 + side;
+
+            // line listed twice in this sector
+            if (sound_line_edges[slot] >= 0)
+                continue;
+
+            sound_line_edges[slot] = (int)sound_edges.size();
+
+            SoundEdge edge;
+            edge.other = (int)(other - level_sectors);
+            edge.flags = SoundEdgeFlagsForLine(ld);
+
+            sound_edges.push_back(edge);
+        }
+    }
+
+    sound_edge_start[total_level_sectors] = (int)sound_edges.size();
+
+    sound_graph_version++;
+    sound_flood_origin = nullptr;
+    audible_origin     = nullptr;
+}
+
+void DestroySoundGraph(void)
+{
+    sound_edge_start.clear();
+    sound_edges.clear();
+    sound_line_edges.clear();
+    sound_flood.clear();
+    audible_stamp.clear();
+
+    sound_graph_version++;
+    sound_flood_origin = nullptr;
+    audible_origin     = nullptr;
+}
+
 //
-static void RecurseSound(Sector *sec, int soundblocks, int player)
+// Refresh the edges of a line after its gaps, slider or flags changed.
+// Does nothing when no graph has been built for the current level.
+//
+void UpdateSoundGraphLine(Line *ld)
 {
-    int     i;
-    Line   *check;
-    Sector *other;
+    if (sound_line_edges.empty() || !level_lines)
+        return;
+
+    int slot = (int)(ld - level_lines) * 2;
 
-    // has the sound flooded this sector
-    if (sec->valid_count == valid_count && sec->sound_traversed <= (soundblocks + 1))
+    if (slot < 0 || slot >= (int)sound_line_edges.size())
         return;
 
+    uint8_t flags = SoundEdgeFlagsForLine(ld);
+
+    for (int side = 0; side < 2; side++)
+    {
+        int e = sound_line_edges[slot + side];
+
+        if (e >= 0 && sound_edges[e].flags != flags)
+        {
+            sound_edges[e].flags = flags;
+            sound_graph_version++;
+        }
+    }
+}
+
+//
+// Breadth-first flood of the graph from the given sector.
+//
+// Sectors reachable without crossing a sound blocking line are heard at
+// level 0, and sectors behind exactly one such line at level 1.  This
+// visits the same sectors at the same levels as the old recursive
+// traversal, without the risk of overflowing the stack on large maps.
+//
+static void FloodSound(Sector *origin)
+{
+    static std::vector<int> queue;
+    static std::vector<int> blocked;
+
+    if (sound_edge_start.empty())
+        BuildSoundGraph();
+
+    sound_flood.clear();
+    queue.clear();
+    blocked.clear();
+
+    sound_flood_origin  = origin;
+    sound_flood_version = sound_graph_version;
+
+    origin->valid_count = valid_count;
+    queue.push_back((int)(origin - level_sectors));
+
+    for (int soundblocks = 0; soundblocks < 2; soundblocks++)
+    {
+        for (size_t head = 0; head < queue.size(); head++)
+        {
+            int s = queue[head];
+
+            SoundFloodEntry entry;
+            entry.sector      = s;
+            entry.soundblocks = soundblocks;
+
+            sound_flood.push_back(entry);
+
+            for (int e = sound_edge_start[s]; e < sound_edge_start[s + 1]; e++)
+            {
+                const SoundEdge &edge = sound_edges[e];
+
+                if (edge.flags & kSoundEdgeClosed)
+                    continue;
+
+                if (edge.flags & kSoundEdgeBlock)
+                {
+                    if (soundblocks == 0)
+                        blocked.push_back(edge.other);
+                    continue;
+                }
+
+                Sector *other = level_sectors + edge.other;
+
+                if (other->valid_count == valid_count)
+                    continue;
+
+                other->valid_count = valid_count;
+                queue.push_back(edge.other);
+            }
+        }
+
+        // seed the next level with the sectors behind sound blocking
+        // lines which were not already heard at this level.
+        queue.clear();
+
+        for (int s : blocked)
+        {
+            Sector *other = level_sectors + s;
+
+            if (other->valid_count == valid_count)
+                continue;
+
+            other->valid_count = valid_count;
+            queue.push_back(s);
+        }
+
+        blocked.clear();
+    }
+}
+
+//
+// Flood of the graph from the listener's sector for sound effects.  Only
+// closed edges stop it; sound blocking lines are for monster hearing.
+//
+static void FloodAudible(Sector *origin)
+{
+    static std::vector<int> queue;
+
+    if ((int)audible_stamp.size() != total_level_sectors)
+        audible_stamp.assign(total_level_sectors, 0);
+
+    audible_current++;
+    audible_origin  = origin;
+    audible_version = sound_graph_version;
+
+    queue.clear();
+    queue.push_back((int)(origin - level_sectors));
+    audible_stamp[queue[0]] = audible_current;
+
+    for (size_t head = 0; head < queue.size(); head++)
+    {
+        int s = queue[head];
+
+        for (int e = sound_edge_start[s]; e < sound_edge_start[s + 1]; e++)
+        {
+            const SoundEdge &edge = sound_edges[e];
+
+            if ((edge.flags & kSoundEdgeClosed) || audible_stamp[edge.other] == audible_current)
+                continue;
+
+            audible_stamp[edge.other] = audible_current;
+            queue.push_back(edge.other);
+        }
+    }
+}
+
+bool SoundSectorAudible(Sector *listener, Sector *source)
+{
+    if (listener == source)
+        return true;
+
+    // no graph for this level (yet), so assume everything is audible
+    if (sound_edge_start.empty())
+        return true;
+
+    if (listener != audible_origin || audible_version != sound_graph_version)
+        FloodAudible(listener);
+
+    return audible_stamp[source - level_sectors] == audible_current;
+}
+
+static void WakeSoundSector(Sector *sec, int soundblocks, int player)
+{
     // wake up all monsters in this sector
     sec->valid_count     = valid_count;
     sec->sound_traversed = soundblocks + 1;
@@ -107,46 +386,30 @@ static void RecurseSound(Sector *sec, int soundblocks, int player)
             }
         }
     }
+}
 
-    for (i = 0; i < sec->line_count; i++)
-    {
-        check = sec->lines[i];
-
-        if (!(check->flags & kLineFlagTwoSided))
-            continue;
-
-        // -AJA- 1999/07/19: Gaps are now stored in line_t.
-        if (check->gap_number == 0)
-            continue; // closed door
-
-        // -AJA- 2001/11/11: handle closed Sliding doors
-        if (check->slide_door && !check->slide_door->s_.see_through_ && !check->slider_move)
-        {
-            continue;
-        }
+//
+// Called by NoiseAlert.
+//
+// Repeated alerts from the same sector (e.g. every shot of a chaingun)
+// reuse the previous flood as long as no edge of the graph changed in
+// between.  Only the monsters are visited again, since they may have
+// moved and hear_distance depends on where the player is now.
+//
+static void PropagateSound(Sector *origin, int player)
+{
+    valid_count++;
 
-        if (check->front_sector == sec)
-            other = check->back_sector;
-        else
-            other = check->front_sector;
+    if (origin != sound_flood_origin || sound_flood_version != sound_graph_version)
+        FloodSound(origin);
 
-        if (check->flags & kLineFlagSoundBlock)
-        {
-            if (!soundblocks)
-                RecurseSound(other, 1, player);
-        }
-        else
-        {
-            RecurseSound(other, soundblocks, player);
-        }
-    }
+    for (const SoundFloodEntry &entry : sound_flood)
+        WakeSoundSector(level_sectors + entry.sector, entry.soundblocks, player);
 }
 
 void NoiseAlert(Player *p)
 {
-    valid_count++;
-
-    RecurseSound(p->map_object_->subsector_->sector, 0, p->player_number_);
+    PropagateSound(p->map_object_->subsector_->sector, p->player_number_);
 }
 
 // MBF21
@@ -154,22 +417,18 @@ void WA_NoiseAlert(MapObject *actor)
 {
     EPI_ASSERT(actor->player_);
 
-    valid_count++;
-
-    RecurseSound(actor->subsector_->sector, 0, actor->player_->player_number_);
+    PropagateSound(actor->subsector_->sector, actor->player_->player_number_);
 }
 
 // Called by new NOISE_ALERT ddf action
 void A_NoiseAlert(MapObject *actor)
 {
-    valid_count++;
-
     int WhatPlayer = 0;
 
     if (actor->last_heard_ != -1)
         WhatPlayer = actor->last_heard_;
 
-    RecurseSound(actor->subsector_->sector, 0, WhatPlayer);
+    PropagateSound(actor->subsector_->sector, WhatPlayer);
 }
 
 //
@@ -577,8 +836,8 @@ MapObject *LookForShootSpot(const MapObjectDefinition *spot_type)
 
     std::vector<MapObject *> spots;
 
-    for (MapObject *cur = map_object_list_head; cur != nullptr; cur = cur->next_)
-        if (cur->info_ == spot_type && !cur->IsRemoved())
+    for (MapObject *cur = FirstMapObjectOfType(spot_type); cur != nullptr; cur = cur->type_next_)
+        if (!cur->IsRemoved())
             spots.push_back(cur);
 
     if (spots.empty())
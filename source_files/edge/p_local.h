@@ -130,6 +130,16 @@ void       RemoveMissile(MapObject *missile);
 void       ExplodeMissile(MapObject *missile);
 MapObject *CreateMapObject(float x, float y, float z, const MapObjectDefinition *type, int tag = 0);
 
+// Every object in map_object_list_head is also linked into a list for
+// its type, so code looking for one type need not scan the whole map.
+// Follow the list with mo->type_next_.  info_ must only be changed via
+// SetMapObjectType().
+MapObject *FirstMapObjectOfType(const MapObjectDefinition *type);
+int        CountMapObjectsOfType(const MapObjectDefinition *type);
+int        CountLiveMapObjectsOfType(const MapObjectDefinition *type);
+int        CountLiveMapObjectsOfNumber(int number);
+void       SetMapObjectType(MapObject *mo, const MapObjectDefinition *type);
+
 // -ACB- 2005/05/06 Sound Effect Category Support
 int GetSoundEffectCategory(const MapObject *mo);
 
@@ -137,6 +147,7 @@ int GetSoundEffectCategory(const MapObject *mo);
 void RemoveAllMapObjects(bool loading);
 void ClearRespawnQueue(void);
 void ClearAllStaleReferences(void);
+void RebuildMapObjectTypeLists(void);
 
 //
 // P_ENEMY
@@ -148,6 +159,12 @@ extern float         xspeed[8];
 extern float         yspeed[8];
 
 void NoiseAlert(Player *p);
+void BuildSoundGraph(void);
+void DestroySoundGraph(void);
+void UpdateSoundGraphLine(Line *ld);
+// true unless every path between the sectors is through a closed door
+// or solid wall (cached for the last listener sector).
+bool SoundSectorAudible(Sector *listener, Sector *source);
 void NewChaseDir(MapObject *actor);
 bool DoMove(MapObject *actor, bool path);
 bool LookForPlayers(MapObject *actor, BAMAngle range, bool ToSupport = false);
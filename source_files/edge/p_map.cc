@@ -2096,6 +2096,8 @@ void UnblockLineEffectDebris(Line *TheLine, const LineType *special)
             TheLine->flags &= ~(kLineFlagBlocking | kLineFlagBlockMonsters | kLineFlagBlockGroundedMonsters |
                                 kLineFlagBlockPlayers | kLineFlagSoundBlock);
 
+            UpdateSoundGraphLine(TheLine);
+
             // clear EDGE's extended lineflags too
             TheLine->flags &= ~(kLineFlagSightBlock | kLineFlagShootBlock);
         }
@@ -39,6 +39,7 @@
 #include <vector>
 
 #include "AlmostEquals.h"
+#include "am_map.h"
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "epi.h"
@@ -931,8 +932,11 @@ void RecomputeGapsAroundSector(Sector *sec)
     for (i = 0; i < sec->line_count; i++)
     {
         ComputeGaps(sec->lines[i]);
+        UpdateSoundGraphLine(sec->lines[i]);
     }
 
+    AutomapSectorChanged(sec);
+
     // now do the sight gaps...
 
     if (sec->ceiling_height <= sec->floor_height)
@@ -52,6 +52,7 @@
 #include "p_mobj.h"
 
 #include <list>
+#include <unordered_map>
 
 #include "AlmostEquals.h"
 #include "con_main.h"
@@ -64,6 +65,7 @@
 #include "i_defs_gl.h"
 #include "i_system.h"
 #include "m_argv.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "n_network.h"
 #include "p_local.h"
@@ -101,6 +103,15 @@ int                             next_available_tid = 1;
 // (help avoid wait until dead scripts that would never fire, etc)
 std::unordered_set<const MapObjectDefinition *> seen_monsters;
 
+// Objects in map_object_list_head, split by type
+struct MapObjectTypeList
+{
+    MapObject *head  = nullptr;
+    int        count = 0;
+};
+
+static std::unordered_map<const MapObjectDefinition *, MapObjectTypeList> map_objects_by_type;
+
 bool time_stop_active = false;
 
 static int MapObjectGetTID()
@@ -1985,6 +1996,112 @@ void ClearAllStaleReferences(void)
     }
 }
 
+static void LinkMobjType(MapObject *mo)
+{
+    MapObjectTypeList &list = map_objects_by_type[mo->info_];
+
+    mo->type_previous_ = nullptr;
+    mo->type_next_     = list.head;
+
+    if (list.head != nullptr)
+        list.head->type_previous_ = mo;
+
+    list.head = mo;
+    list.count++;
+}
+
+static void UnlinkMobjType(MapObject *mo)
+{
+    auto iter = map_objects_by_type.find(mo->info_);
+
+    EPI_ASSERT(iter != map_objects_by_type.end());
+
+    MapObjectTypeList &list = iter->second;
+
+    if (mo->type_previous_ != nullptr)
+    {
+        EPI_ASSERT(mo->type_previous_->type_next_ == mo);
+        mo->type_previous_->type_next_ = mo->type_next_;
+    }
+    else // no previous, must be first item
+    {
+        EPI_ASSERT(list.head == mo);
+        list.head = mo->type_next_;
+    }
+
+    if (mo->type_next_ != nullptr)
+    {
+        EPI_ASSERT(mo->type_next_->type_previous_ == mo);
+        mo->type_next_->type_previous_ = mo->type_previous_;
+    }
+
+    mo->type_next_     = nullptr;
+    mo->type_previous_ = nullptr;
+
+    list.count--;
+}
+
+void RebuildMapObjectTypeLists(void)
+{
+    map_objects_by_type.clear();
+
+    for (MapObject *mo = map_object_list_head; mo != nullptr; mo = mo->next_)
+        LinkMobjType(mo);
+}
+
+MapObject *FirstMapObjectOfType(const MapObjectDefinition *type)
+{
+    auto iter = map_objects_by_type.find(type);
+
+    return (iter != map_objects_by_type.end()) ? iter->second.head : nullptr;
+}
+
+int CountMapObjectsOfType(const MapObjectDefinition *type)
+{
+    auto iter = map_objects_by_type.find(type);
+
+    return (iter != map_objects_by_type.end()) ? iter->second.count : 0;
+}
+
+int CountLiveMapObjectsOfType(const MapObjectDefinition *type)
+{
+    // health is changed in too many places to keep a running count
+    // of live objects, but only objects of this type are visited.
+    int count = 0;
+
+    for (MapObject *mo = FirstMapObjectOfType(type); mo != nullptr; mo = mo->type_next_)
+    {
+        if (mo->health_ > 0)
+            count++;
+    }
+
+    return count;
+}
+
+int CountLiveMapObjectsOfNumber(int number)
+{
+    // several types can share a number, so check every type present
+    int count = 0;
+
+    for (auto &entry : map_objects_by_type)
+    {
+        if (entry.first && entry.first->number_ == number)
+            count += CountLiveMapObjectsOfType(entry.first);
+    }
+
+    return count;
+}
+
+void SetMapObjectType(MapObject *mo, const MapObjectDefinition *type)
+{
+    if (mo->info_ == type)
+        return;
+
+    UnlinkMobjType(mo);
+    mo->info_ = type;
+    LinkMobjType(mo);
+}
+
 static void AddMobjToList(MapObject *mo)
 {
     mo->previous_ = nullptr;
@@ -1999,6 +2116,8 @@ static void AddMobjToList(MapObject *mo)
     map_object_list_head = mo;
     seen_monsters.insert(mo->info_);
 
+    LinkMobjType(mo);
+
 #if (EDGE_DEBUG_MAP_OBJECTS > 0)
     LogDebug("tics=%05d  ADD %p [%s]\n", level_time_elapsed, mo, mo->info_ ? mo->info_->name_.c_str() : "???");
 #endif
@@ -2027,6 +2146,8 @@ static void RemoveMobjFromList(MapObject *mo)
         mo->next_->previous_ = mo->previous_;
     }
 
+    UnlinkMobjType(mo);
+
     /*
         if (mo->tag_)
         {
@@ -2161,6 +2282,7 @@ void RemoveAllMapObjects(bool loading)
         mo->reference_count_ = 0;
         DeleteMobj(mo);
     }
+    map_objects_by_type.clear();
     active_tagged_map_objects.clear();
     active_tids.clear();
     next_available_tid = 1;
@@ -2185,6 +2307,8 @@ void ClearRespawnQueue(void)
 //
 void RunMapObjectThinkers()
 {
+    EDGE_PROFILE_SCOPE("RunMapObjectThinkers");
+
     MapObject *mo;
     MapObject *next;
 
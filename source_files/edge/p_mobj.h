@@ -373,6 +373,10 @@ class MapObject : public Position
     MapObject *next_     = nullptr;
     MapObject *previous_ = nullptr;
 
+    // linked list of objects with the same info_ (FirstMapObjectOfType)
+    MapObject *type_next_     = nullptr;
+    MapObject *type_previous_ = nullptr;
+
     // Interaction info, by BLOCKMAP.
     // Links in blocks (if needed).
     MapObject *blockmap_next_     = nullptr;
@@ -26,11 +26,13 @@
 #include <algorithm>
 
 #include "AlmostEquals.h"
+#include "am_map.h"
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "epi.h"
 #include "epi_doomdefs.h"
 #include "epi_str_compare.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "n_network.h"
 #include "p_local.h"
@@ -1358,6 +1360,7 @@ static bool MoveSlider(SlidingDoorMover *smov)
 
         // mark line as non-blocking (at some point)
         ComputeGaps(smov->line);
+        UpdateSoundGraphLine(smov->line);
 
         if (smov->opening >= smov->target)
         {
@@ -1375,6 +1378,9 @@ static bool MoveSlider(SlidingDoorMover *smov)
                 ld->slide_door = nullptr;
                 ld->special    = nullptr;
 
+                UpdateSoundGraphLine(ld);
+                AutomapLineChanged(ld);
+
                 // clear the side textures
                 ld->side[0]->middle.image = nullptr;
                 ld->side[1]->middle.image = nullptr;
@@ -1395,6 +1401,7 @@ static bool MoveSlider(SlidingDoorMover *smov)
 
             // mark line as blocking (at some point)
             ComputeGaps(smov->line);
+            UpdateSoundGraphLine(smov->line);
 
             if (smov->opening <= 0.0f)
             {
@@ -1411,6 +1418,7 @@ static bool MoveSlider(SlidingDoorMover *smov)
 
             // mark line as non-blocking (at some point)
             ComputeGaps(smov->line);
+            UpdateSoundGraphLine(smov->line);
 
             if (smov->opening >= smov->target)
             {
@@ -1428,6 +1436,9 @@ static bool MoveSlider(SlidingDoorMover *smov)
                     ld->slide_door = nullptr;
                     ld->special    = nullptr;
 
+                    UpdateSoundGraphLine(ld);
+                    AutomapLineChanged(ld);
+
                     // clear the side textures
                     ld->side[0]->middle.image = nullptr;
                     ld->side[1]->middle.image = nullptr;
@@ -1492,6 +1503,9 @@ bool RunSlidingDoor(Line *door, Line *act_line, MapObject *thing, const LineType
     door->slide_door  = special;
     door->slider_move = smov;
 
+    UpdateSoundGraphLine(door);
+    AutomapLineChanged(door);
+
     // work-around for RTS-triggered doors, which cannot setup
     // the 'slide_door' field at level load and hence the code
     // which normally blocks the door does not kick in.
@@ -1516,6 +1530,8 @@ bool RunSlidingDoor(Line *door, Line *act_line, MapObject *thing, const LineType
 //
 void RunActivePlanes(void)
 {
+    EDGE_PROFILE_SCOPE("RunActivePlanes");
+
     if (time_stop_active)
         return;
 
@@ -1729,6 +1745,7 @@ void RunActiveSliders(void)
         if (MoveSlider(smov))
         {
             smov->line->slider_move = nullptr;
+            UpdateSoundGraphLine(smov->line);
 
             *SMI = nullptr;
             delete smov;
@@ -294,7 +294,6 @@ static void CheckDoom2Map05Bug(uint8_t *data, int length)
 
 static void LoadVertexes(int lump)
 {
-    const uint8_t   *data;
     int              i;
     const RawVertex *ml;
     Vertex          *li;
@@ -311,10 +310,10 @@ static void LoadVertexes(int lump)
 
     level_vertexes = new Vertex[total_level_vertexes];
 
-    // Load data into cache.
-    data = LoadLumpIntoMemory(lump);
+    // Use the lump in place where possible.
+    LumpView data(lump);
 
-    ml = (const RawVertex *)data;
+    ml = (const RawVertex *)data.GetData();
     li = level_vertexes;
 
     int min_x = 0;
@@ -339,9 +338,6 @@ static void LoadVertexes(int lump)
     GenerateBlockmap(min_x, min_y, max_x, max_y);
 
     CreateThingBlockmap();
-
-    // Free buffer memory.
-    delete[] data;
 }
 
 static void SegCommonStuff(Seg *seg, int linedef_in)
@@ -922,11 +918,11 @@ static void LoadLineDefs(int lump)
 
     temp_line_sides = new int[total_level_lines * 2];
 
-    const uint8_t *data = LoadLumpIntoMemory(lump);
-    map_lines_crc.AddBlock((const uint8_t *)data, GetLumpLength(lump));
+    LumpView data(lump);
+    map_lines_crc.AddBlock(data.GetData(), data.GetLength());
 
     Line             *ld  = level_lines;
-    const RawLinedef *mld = (const RawLinedef *)data;
+    const RawLinedef *mld = (const RawLinedef *)data.GetData();
 
     for (int i = 0; i < total_level_lines; i++, mld++, ld++)
     {
@@ -984,8 +980,6 @@ static void LoadLineDefs(int lump)
 
         BlockmapAddLine(ld);
     }
-
-    delete[] data;
 }
 
 static Sector *DetermineSubsectorSector(Subsector *ss, int pass)
@@ -3385,6 +3379,7 @@ void ShutdownLevel(void)
     DestroyAllPlanes();
     DestroyAllSliders();
     DestroyAllAmbientSounds();
+    DestroySoundGraph();
 
     DDFBoomClearGeneralizedTypes();
 
@@ -3572,13 +3567,19 @@ void LevelSetup(void)
 
     SpawnMapSpecials2(current_map->autotag_);
 
+    BuildSoundGraph();
+
     AutomapInitLevel();
 
-    UpdateSkyboxTextures();
+    // both of these upload textures
+    if (!headless_mode)
+    {
+        UpdateSkyboxTextures();
 
-    // preload graphics
-    if (precache)
-        PrecacheLevelGraphics();
+        // preload graphics
+        if (precache)
+            PrecacheLevelGraphics();
+    }
 
     ChangeMusic(current_map->music_, true); // start level music
 
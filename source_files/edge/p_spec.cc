@@ -32,6 +32,7 @@
 #include <limits.h>
 
 #include "AlmostEquals.h"
+#include "am_map.h"
 #include "con_main.h"
 #include "dm_defs.h"
 #include "dm_state.h"
@@ -42,6 +43,7 @@
 #include "f_interm.h"
 #include "g_game.h"
 #include "m_argv.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "n_network.h"
 #include "p_local.h"
@@ -1279,7 +1281,10 @@ static bool P_ActivateSpecialLine(Line *line, const LineType *special, int tag,
     if (!CheckWhenAppear(special->appear_))
     {
         if (line)
+        {
             line->special = nullptr;
+            AutomapLineChanged(line);
+        }
 
         return true;
     }
@@ -1705,6 +1710,8 @@ static bool P_ActivateSpecialLine(Line *line, const LineType *special, int tag,
             line->special = (special->newtrignum_ <= 0) ? nullptr : LookupLineType(special->newtrignum_);
         }
 
+        AutomapLineChanged(line);
+
         // Lobo 2026: we dont' want to play the switch SFX on walkable lines even though they have a switch texture
         if (line->special && line->special->type_ == kLineTriggerWalkable)
             playedSound = true;
@@ -2016,6 +2023,8 @@ void PlayerInSpecialSector(Player *player, Sector *sec, bool should_choke)
 //
 void UpdateSpecials()
 {
+    EDGE_PROFILE_SCOPE("UpdateSpecials");
+
     // For anim stuff
     float factor = 1.0f;
 
@@ -34,6 +34,7 @@
 #include "AlmostEquals.h"
 #include "dm_state.h"
 #include "g_game.h"
+#include "m_profile.h"
 #include "n_network.h"
 #include "p_local.h"
 #include "p_spec.h"
@@ -52,6 +53,8 @@ extern ConsoleVariable erraticism;
 //
 void MapObjectTicker()
 {
+    EDGE_PROFILE_SCOPE("MapObjectTicker");
+
     if (paused || console_active)
         return;
 
@@ -867,6 +867,7 @@ static void ParseUMAPINFOEntry(epi::Scanner &lex, MapEntry *val)
                 new_epi->namegraphic_ = lumpname;
                 new_epi->description_ = alttext;
                 new_epi->name_        = epi::StringFormat("UMAPINFO_%s\n", val->mapname); // Internal
+                gamedefs.InvalidateNameIndex();
             }
         }
         break;
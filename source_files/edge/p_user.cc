@@ -36,6 +36,7 @@
 #include "g_game.h"
 #include "i_sound.h"
 #include "i_system.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "n_network.h"
 #include "p_blockmap.h"
@@ -50,8 +51,6 @@
 #include "vm_coal.h"
 
 extern coal::VM *ui_vm;
-extern void      COALSetVector(coal::VM *vm, const char *mod_name, const char *var_name, double val_1, double val_2,
-                               double val_3);
 
 EDGE_DEFINE_CONSOLE_VARIABLE(erraticism, "0", kConsoleVariableFlagArchive)
 
@@ -765,6 +764,8 @@ void P_DumpMobjsTemp(void)
 
 bool PlayerThink(Player *player)
 {
+    EDGE_PROFILE_SCOPE("PlayerThink");
+
     EventTicCommand *cmd = &player->command_;
 
     EPI_ASSERT(player->map_object_);
@@ -921,7 +922,7 @@ bool PlayerThink(Player *player)
                                 cmd->extended_buttons & kExtendedButtonCodeInventoryUse ? 1.0f : 0.0f,
                                 cmd->extended_buttons & kExtendedButtonCodeInventoryNext ? 1.0f : 0.0f}});
     else
-        COALSetVector(ui_vm, "player", "inventory_event_handler",
+        COALSetVector(ui_vm, coal_player_inventory_event_handler,
                       cmd->extended_buttons & kExtendedButtonCodeInventoryPrevious ? 1 : 0,
                       cmd->extended_buttons & kExtendedButtonCodeInventoryUse ? 1 : 0,
                       cmd->extended_buttons & kExtendedButtonCodeInventoryNext ? 1 : 0);
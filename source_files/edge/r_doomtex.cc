@@ -33,6 +33,8 @@
 
 #include <limits.h>
 
+#include <unordered_map>
+
 #include "dm_state.h"
 #include "e_main.h"
 #include "e_search.h"
@@ -79,6 +81,10 @@ static constexpr uint8_t dummy_graphic[kDummyImageSize * kDummyImageSize] = {
     0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0,
     0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 
+uint8_t   *ReadImageSource(Image *rim, int *length);
+ImageData *DecodeImageSource(const Image *rim, const uint8_t *data, int length, int *opacity, bool *is_empty);
+void       ImageSourceFailed(const Image *rim);
+
 //
 //  UTILITY
 //
@@ -196,18 +202,14 @@ static ImageData *ReadFlatAsEpiBlock(Image *rim)
 }
 
 //
-// ReadTextureAsBlock
+// ComposeTexture
 //
-// Loads a texture from the wad and returns the image block for it.
-// Doesn't do any mipmapping (this is too "raw" if you follow).
-//
-//---- This routine will also update the `solid' flag
-//---- if texture turns out to be solid.
+// Builds a texture from its patches in the wad and returns the image
+// block for it.  Doesn't do any mipmapping (this is too "raw" if you
+// follow).
 //
-static ImageData *ReadTextureAsEpiBlock(Image *rim)
+static ImageData *ComposeTexture(Image *rim)
 {
-    EPI_ASSERT(rim->source_type_ == kImageSourceTexture);
-
     TextureDefinition *tdef = rim->source_texture_.tdef;
     EPI_ASSERT(tdef);
 
@@ -216,17 +218,9 @@ static ImageData *ReadTextureAsEpiBlock(Image *rim)
 
     ImageData *img = new ImageData(tw, th, 1);
 
-    // Clear initial pixels to either totally transparent, or totally
-    // black (if we know the image should be solid).
-    //
-    //---- If the image turns
-    //---- out to be solid instead of transparent, the transparent pixels
-    //---- will be blackened.
-
-    if (rim->opacity_ == kOpacitySolid)
-        img->Clear(playpal_black);
-    else
-        img->Clear(kTransparentPixelIndex);
+    // Start totally transparent; ReadTextureAsEpiBlock() blackens the
+    // gaps once the texture is known to be solid.
+    img->Clear(kTransparentPixelIndex);
 
     int           i;
     TexturePatch *patch;
@@ -234,9 +228,11 @@ static ImageData *ReadTextureAsEpiBlock(Image *rim)
     // Composite the columns into the block.
     for (i = 0, patch = tdef->patches; i < tdef->patch_count; i++, patch++)
     {
-        const Patch *realpatch = (const Patch *)LoadLumpIntoMemory(patch->patch);
+        LumpView patch_lump(patch->patch);
 
-        int realsize = GetLumpLength(patch->patch);
+        const Patch *realpatch = (const Patch *)patch_lump.GetData();
+
+        int realsize = patch_lump.GetLength();
 
         int x1 = patch->origin_x;
         int y1 = patch->origin_y;
@@ -260,9 +256,89 @@ static ImageData *ReadTextureAsEpiBlock(Image *rim)
 
             DrawColumnIntoEpiBlock(rim, img, patchcol, x, y1);
         }
+    }
 
-        delete[] realpatch;
+    return img;
+}
+
+//
+// Composited textures, in palette indices.  Building one means walking
+// every column of every patch, and it is needed again for each colormap
+// or whitened variant of the texture and after every DeleteAllImages().
+// Those only differ in palette and later processing, so the composite is
+// kept here and copied out.  Only used from the main thread.
+//
+static constexpr size_t kTextureCompositeBudget = 64 * 1024 * 1024;
+
+static std::unordered_map<const TextureDefinition *, ImageData *> texture_composites;
+static size_t                                                     texture_composite_bytes = 0;
+
+void ClearTextureComposites(void)
+{
+    for (auto &entry : texture_composites)
+        delete entry.second;
+
+    texture_composites.clear();
+    texture_composite_bytes = 0;
+}
+
+//
+// ReadTextureAsBlock
+//
+// Loads a texture from the wad and returns the image block for it.
+//
+static ImageData *ReadTextureAsEpiBlock(Image *rim)
+{
+    EPI_ASSERT(rim->source_type_ == kImageSourceTexture);
+
+    const TextureDefinition *tdef = rim->source_texture_.tdef;
+    EPI_ASSERT(tdef);
+
+    ImageData *composite = nullptr;
+
+    auto found = texture_composites.find(tdef);
+
+    if (found != texture_composites.end() && found->second->width_ == rim->width_ &&
+        found->second->height_ == rim->height_)
+    {
+        composite = found->second;
     }
+    else
+    {
+        if (found != texture_composites.end())
+        {
+            texture_composite_bytes -= (size_t)found->second->width_ * found->second->height_;
+            delete found->second;
+            texture_composites.erase(found);
+        }
+
+        composite = ComposeTexture(rim);
+
+        size_t size = (size_t)composite->width_ * composite->height_;
+
+        if (texture_composite_bytes + size > kTextureCompositeBudget)
+            ClearTextureComposites();
+
+        texture_composites[tdef] = composite;
+        texture_composite_bytes += size;
+    }
+
+    ImageData *img = new ImageData(composite->width_, composite->height_, 1);
+
+    int total = composite->width_ * composite->height_;
+
+    // the caller owns (and may swirl) the image, so always hand out a copy.
+    // Gaps are blackened if we know the image should be solid.
+    if (rim->opacity_ == kOpacitySolid)
+    {
+        for (int i = 0; i < total; i++)
+        {
+            uint8_t pix     = composite->pixels_[i];
+            img->pixels_[i] = (pix == kTransparentPixelIndex) ? playpal_black : pix;
+        }
+    }
+    else
+        memcpy(img->pixels_, composite->pixels_, total);
 
     return img;
 }
@@ -288,20 +364,15 @@ static ImageData *ReadPatchAsEpiBlock(Image *rim)
     // handle PNG/JPEG/TGA images
     if (!rim->source_graphic_.is_patch)
     {
-        epi::File *f;
+        int      length;
+        uint8_t *data = ReadImageSource(rim, &length);
 
-        if (packfile_name)
-            f = OpenFileFromPack(packfile_name);
-        else
-            f = LoadLumpAsFile(lump);
-
-        ImageData *img = LoadImageData(f);
+        ImageData *img = DecodeImageSource(rim, data, length, &rim->opacity_, &rim->is_empty_);
 
-        // close it
-        delete f;
+        delete[] data;
 
         if (!img)
-            FatalError("Error loading image in lump: %s\n", packfile_name ? packfile_name : GetLumpNameFromIndex(lump));
+            ImageSourceFailed(rim);
 
         return img;
     }
@@ -463,22 +534,93 @@ epi::File *OpenUserFileOrLump(ImageDefinition *def)
     }
 }
 
-static ImageData *CreateUserFileImage(Image *rim, ImageDefinition *def)
+static ImageData *CreateUserFileImage(Image *rim)
 {
-    epi::File *f = OpenUserFileOrLump(def);
+    int      length;
+    uint8_t *data = ReadImageSource(rim, &length);
+
+    ImageData *img = DecodeImageSource(rim, data, length, &rim->opacity_, &rim->is_empty_);
+
+    delete[] data;
+
+    if (!img)
+        ImageSourceFailed(rim);
+
+    return img;
+}
+
+//
+// ReadImageSource
+//
+// For images stored as PNG/JPEG/TGA (etc), reads the still-encoded
+// data into memory, so that the expensive decode can happen away from
+// the main thread.  Returns nullptr for images which are built directly
+// from lump data (patches, flats, textures, etc).
+// The returned buffer must be freed with delete[].
+//
+uint8_t *ReadImageSource(Image *rim, int *length)
+{
+    epi::File *f = nullptr;
+
+    if (rim->source_type_ == kImageSourceGraphic || rim->source_type_ == kImageSourceSprite ||
+        rim->source_type_ == kImageSourceTXHI)
+    {
+        if (rim->source_graphic_.is_patch)
+            return nullptr;
+
+        if (rim->source_graphic_.packfile_name)
+            f = OpenFileFromPack(rim->source_graphic_.packfile_name);
+        else
+            f = LoadLumpAsFile(rim->source_graphic_.lump);
+
+        if (!f)
+            FatalError("Error loading image in lump: %s\n", rim->source_graphic_.packfile_name
+                                                                ? rim->source_graphic_.packfile_name
+                                                                : GetLumpNameFromIndex(rim->source_graphic_.lump));
+    }
+    else if (rim->source_type_ == kImageSourceUser)
+    {
+        ImageDefinition *def = rim->source_user_.def;
 
-    if (!f)
-        FatalError("Missing image file: %s\n", def->info_.c_str());
+        if (def->type_ != kImageDataFile && def->type_ != kImageDataLump && def->type_ != kImageDataPackage)
+            return nullptr;
 
-    ImageData *img = LoadImageData(f);
+        f = OpenUserFileOrLump(def);
+
+        if (!f)
+            FatalError("Missing image file: %s\n", def->info_.c_str());
+    }
+    else
+        return nullptr;
+
+    *length       = f->GetLength();
+    uint8_t *data = f->LoadIntoMemory();
 
     // close it
     delete f;
 
-    if (!img)
-        FatalError("Error occurred loading image file: %s\n", def->info_.c_str());
+    return data;
+}
 
-    rim->opacity_ = DetermineOpacity(img, &rim->is_empty_);
+//
+// DecodeImageSource
+//
+// Decodes data previously read by ReadImageSource().  Never modifies the
+// image or reports errors, hence is safe to run on a worker thread: the
+// opacity of user images is stored via 'opacity' and 'is_empty', and on
+// failure nullptr is returned, for the caller to pass to
+// ImageSourceFailed() on the main thread.
+//
+ImageData *DecodeImageSource(const Image *rim, const uint8_t *data, int length, int *opacity, bool *is_empty)
+{
+    ImageData *img = data ? LoadImageData(data, length) : nullptr;
+
+    if (!img || rim->source_type_ != kImageSourceUser)
+        return img;
+
+    const ImageDefinition *def = rim->source_user_.def;
+
+    *opacity = DetermineOpacity(img, is_empty);
 
     if (def->is_font_)
         return img;
@@ -492,6 +634,16 @@ static ImageData *CreateUserFileImage(Image *rim, ImageDefinition *def)
     return img;
 }
 
+void ImageSourceFailed(const Image *rim)
+{
+    if (rim->source_type_ == kImageSourceUser)
+        FatalError("Error occurred loading image file: %s\n", rim->source_user_.def->info_.c_str());
+
+    FatalError("Error loading image in lump: %s\n", rim->source_graphic_.packfile_name
+                                                        ? rim->source_graphic_.packfile_name
+                                                        : GetLumpNameFromIndex(rim->source_graphic_.lump));
+}
+
 //
 // ReadUserAsEpiBlock
 //
@@ -512,7 +664,7 @@ static ImageData *ReadUserAsEpiBlock(Image *rim)
     case kImageDataFile:
     case kImageDataLump:
     case kImageDataPackage:
-        return CreateUserFileImage(rim, def);
+        return CreateUserFileImage(rim);
 
     default:
         FatalError("ReadUserAsEpiBlock: Coding error, unknown type %d\n", def->type_);
@@ -35,9 +35,11 @@
 
 #include <limits.h>
 
+#include <deque>
 #include <list>
 #include <map>
 
+#include "con_var.h"
 #include "ddf_flat.h"
 #include "ddf_font.h"
 #include "dm_defs.h"
@@ -49,12 +51,16 @@
 #include "epi_endian.h"
 #include "epi_file.h"
 #include "epi_filesystem.h"
+#include "epi_md5.h"
 #include "epi_str_compare.h"
 #include "epi_str_hash.h"
 #include "epi_str_util.h"
+#include "epi_thread.h"
+#include "dstrings.h"
 #include "hu_draw.h" // hud_tic
 #include "i_defs_gl.h"
 #include "i_system.h"
+#include "im_cache.h"
 #include "im_data.h"
 #include "im_filter.h"
 #include "im_funcs.h"
@@ -62,6 +68,7 @@
 #include "m_menu.h"
 #include "m_misc.h"
 #include "p_local.h"
+#include "r_backend.h"
 #include "r_colormap.h"
 #include "r_defs.h"
 #include "r_gldefs.h"
@@ -77,7 +84,17 @@
 
 LiquidSwirl swirling_flats = kLiquidSwirlVanilla;
 
+EDGE_DEFINE_CONSOLE_VARIABLE(image_threaded_precache, "1", kConsoleVariableFlagArchive)
+EDGE_DEFINE_CONSOLE_VARIABLE(image_disk_cache, "1", kConsoleVariableFlagArchive)
+
+// in megabytes, read at startup
+EDGE_DEFINE_CONSOLE_VARIABLE_CLAMPED(image_disk_cache_size, "256", kConsoleVariableFlagArchive, 16, 8192)
+
 extern ImageData *ReadAsEpiBlock(Image *rim);
+extern void       ClearTextureComposites(void);
+extern uint8_t   *ReadImageSource(Image *rim, int *length);
+extern ImageData *DecodeImageSource(const Image *rim, const uint8_t *data, int length, int *opacity, bool *is_empty);
+extern void       ImageSourceFailed(const Image *rim);
 
 extern epi::File *OpenUserFileOrLump(ImageDefinition *def);
 
@@ -110,6 +127,9 @@ struct CachedImage
     GLuint texture_id;
 
     bool is_whitened;
+
+    // queued for a threaded precache, texture_id not set yet
+    bool is_pending;
 };
 
 // total set of images
@@ -260,6 +280,7 @@ void StoreBlurredImage(const Image *image)
         img->blurred_version_->offset_x_          = img->offset_x_;
         img->blurred_version_->offset_y_          = img->offset_y_;
         img->blurred_version_->opacity_           = img->opacity_;
+        img->blurred_version_->source_opacity_    = img->source_opacity_;
         img->blurred_version_->scale_x_           = img->scale_x_;
         img->blurred_version_->scale_y_           = img->scale_y_;
         img->blurred_version_->source_graphic_    = img->source_graphic_;
@@ -294,6 +315,7 @@ static Image *NewImage(int width, int height, int opacity = kOpacityUnknown)
     rim->offset_x_ = rim->offset_y_ = 0;
     rim->scale_x_ = rim->scale_y_ = 1.0f;
     rim->opacity_                 = opacity;
+    rim->source_opacity_          = opacity;
     rim->is_empty_                = false;
     rim->is_font_                 = false;
 
@@ -1247,101 +1269,285 @@ static int IM_PixelLimit()
         return (1 << 22);
 }
 
-static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
+//
+// Everything needed to turn an image into a texture.  The CPU heavy part
+// (decoding, HQ2x, blurring, shrinking) is done in Run(), which only reads
+// the image and writes to the job, so it can happen on a worker thread.
+// The opacity and bounds it finds are copied to the image, and the GL
+// upload done, by FinishImageUpload() on the main thread.
+//
+class ImageUploadJob : public epi::WorkerJob
+{
+  public:
+    Image          *rim_       = nullptr;
+    const Colormap *trans_     = nullptr;
+    bool            do_whiten_ = false;
+
+    bool clamp_  = false;
+    bool mip_    = false;
+    bool smooth_ = false;
+    bool flip_   = false;
+    bool invert_ = false;
+
+    int max_pix_ = 0;
+
+    bool use_disk_cache_ = false;
+
+    uint8_t palette_[256 * 3];
+
+    // either the raw block, or the still-encoded PNG/JPEG/etc data
+    ImageData *source_img_    = nullptr;
+    uint8_t   *source_data_   = nullptr;
+    int        source_length_ = 0;
+
+    int swirl_tic_ = 0;
+
+    // output, result_ is nullptr if the source could not be decoded
+    ImageData     *result_       = nullptr;
+    int            upload_flags_ = 0;
+    ImageCacheInfo info_;
+
+    ~ImageUploadJob() override
+    {
+        delete source_img_;
+        delete[] source_data_;
+        delete result_;
+    }
+
+    void Run() override;
+
+  private:
+    bool        ShouldDiskCache() const;
+    std::string DiskCacheKey() const;
+    void        CalcUploadFlags();
+};
+
+// each worker thread (and the main thread) keeps its own HQ2x tables,
+// so images can be scaled in parallel
+static thread_local HQ2xPalette hq2x_palette;
+
+//
+// Gathers the settings and source data for loading an image.
+// PNG/JPEG/TGA images are only read into memory here and decoded
+// later in the job (if not found in the disk cache).
+//
+static void SetupImageUpload(ImageUploadJob *job, Image *rim, const Colormap *trans, bool do_whiten)
 {
-    bool clamp  = IM_ShouldClamp(rim);
-    bool mip    = IM_ShouldMipmap(rim);
-    bool smooth = IM_ShouldSmooth(rim);
-    bool flip   = false;
-    bool invert = false;
+    job->rim_       = rim;
+    job->trans_     = trans;
+    job->do_whiten_ = do_whiten;
 
-    int max_pix = IM_PixelLimit();
+    job->info_.opacity  = rim->opacity_;
+    job->info_.is_empty = rim->is_empty_ ? 1 : 0;
+
+    job->clamp_  = IM_ShouldClamp(rim);
+    job->mip_    = IM_ShouldMipmap(rim);
+    job->smooth_ = IM_ShouldSmooth(rim);
+
+    job->max_pix_ = IM_PixelLimit();
 
     if (rim->source_type_ == kImageSourceUser)
     {
         if (rim->source_user_.def->special_ & kImageSpecialClamp)
-            clamp = true;
+            job->clamp_ = true;
 
         if (rim->source_user_.def->special_ & kImageSpecialMip)
-            mip = true;
+            job->mip_ = true;
         else if (rim->source_user_.def->special_ & kImageSpecialNoMip)
-            mip = false;
+            job->mip_ = false;
 
         if (rim->source_user_.def->special_ & kImageSpecialSmooth)
-            smooth = true;
+            job->smooth_ = true;
         else if (rim->source_user_.def->special_ & kImageSpecialNoSmooth)
-            smooth = false;
+            job->smooth_ = false;
 
-        flip = (rim->source_user_.def->special_ & kImageSpecialFlip);
+        job->flip_ = (rim->source_user_.def->special_ & kImageSpecialFlip);
 
-        invert = (rim->source_user_.def->special_ & kImageSpecialInvert);
+        job->invert_ = (rim->source_user_.def->special_ & kImageSpecialInvert);
     }
     else if (rim->source_graphic_.user_defined)
     {
         if (rim->source_graphic_.special & kImageSpecialClamp)
-            clamp = true;
+            job->clamp_ = true;
 
         if (rim->source_graphic_.special & kImageSpecialMip)
-            mip = true;
+            job->mip_ = true;
         else if (rim->source_graphic_.special & kImageSpecialNoMip)
-            mip = false;
+            job->mip_ = false;
 
         if (rim->source_graphic_.special & kImageSpecialSmooth)
-            smooth = true;
+            job->smooth_ = true;
         else if (rim->source_graphic_.special & kImageSpecialNoSmooth)
-            smooth = false;
+            job->smooth_ = false;
 
-        flip = (rim->source_graphic_.special & kImageSpecialFlip);
+        job->flip_ = (rim->source_graphic_.special & kImageSpecialFlip);
 
-        invert = (rim->source_graphic_.special & kImageSpecialInvert);
+        job->invert_ = (rim->source_graphic_.special & kImageSpecialInvert);
     }
 
-    const uint8_t *what_palette    = (const uint8_t *)&playpal_data[0];
-    bool           what_pal_cached = false;
-
-    static uint8_t trans_pal[256 * 3];
-
     if (trans != nullptr)
     {
         // Note: we don't care about source_palette here. It's likely that
         // the translation table itself would not match the other palette,
         // and so we would still end up with messed up colours.
 
-        TranslatePalette(trans_pal, what_palette, trans);
-        what_palette = trans_pal;
+        TranslatePalette(job->palette_, (const uint8_t *)&playpal_data[0], trans);
     }
     else if (rim->source_palette_ >= 0)
     {
-        what_palette    = (const uint8_t *)LoadLumpIntoMemory(rim->source_palette_);
-        what_pal_cached = true;
+        const uint8_t *what_palette = (const uint8_t *)LoadLumpIntoMemory(rim->source_palette_);
+        memcpy(job->palette_, what_palette, 256 * 3);
+        delete[] what_palette;
     }
+    else
+        memcpy(job->palette_, &playpal_data[0], 256 * 3);
 
-    ImageData *tmp_img = ReadAsEpiBlock(rim);
+    job->use_disk_cache_ = image_disk_cache.d_ && ImageDiskCacheEnabled();
+
+    job->source_data_ = ReadImageSource(rim, &job->source_length_);
+
+    if (!job->source_data_)
+        job->source_img_ = ReadAsEpiBlock(rim);
 
     if (rim->liquid_type_ > kLiquidImageNone &&
         (swirling_flats == kLiquidSwirlSmmu || swirling_flats == kLiquidSwirlSmmuSlosh))
     {
         rim->swirled_game_tic_ = hud_tic;
-        tmp_img->Swirl(rim->swirled_game_tic_,
+        job->swirl_tic_        = hud_tic;
+    }
+}
+
+//
+// Only images which are costly to produce are worth a trip to the
+// disk: those decoded from PNG/JPEG/etc, or run through HQ2x or blur.
+// Swirling liquids change every tic, so are never cached.
+//
+bool ImageUploadJob::ShouldDiskCache() const
+{
+    if (!use_disk_cache_)
+        return false;
+
+    if (rim_->liquid_type_ > kLiquidImageNone &&
+        (swirling_flats == kLiquidSwirlSmmu || swirling_flats == kLiquidSwirlSmmuSlosh))
+        return false;
+
+    if (source_data_ || rim_->blur_sigma_ > 0.0f)
+        return true;
+
+    return source_img_->depth_ == 1 && IM_ShouldHQ2X(rim_);
+}
+
+//
+// The key covers the source data, the palette, and every setting which
+// affects the processed image, so a change to any of them simply misses.
+// The opacity is the one the image was created with, since opacity_
+// itself changes once the first load has determined it.
+//
+std::string ImageUploadJob::DiskCacheKey() const
+{
+    std::string source_hash;
+
+    if (source_data_)
+    {
+        source_hash = epi::MD5Hash(source_data_, source_length_).ToString();
+    }
+    else
+    {
+        int total   = source_img_->width_ * source_img_->height_ * source_img_->depth_;
+        source_hash = epi::StringFormat("%dx%dx%d:", source_img_->width_, source_img_->height_, source_img_->depth_);
+        source_hash += epi::MD5Hash(source_img_->pixels_, total).ToString();
+    }
+
+    std::string palette_hash = epi::MD5Hash(palette_, sizeof(palette_)).ToString();
+
+    int fix_trans = 0;
+
+    if (rim_->source_type_ == kImageSourceUser)
+        fix_trans = rim_->source_user_.def->fix_trans_;
+
+#ifdef EDGE_SOKOL
+    const int sokol = 1;
+#else
+    const int sokol = 0;
+#endif
+
+    std::string settings = epi::StringFormat(
+        "%s:%s:hq%d:font%d:blur%g:hsv%d,%d,%d:trans%d:white%d:flip%d:inv%d:fix%d:op%d:pix%d:max%d:sokol%d",
+        source_hash.c_str(), palette_hash.c_str(), IM_ShouldHQ2X(rim_) ? 1 : 0, rim_->is_font_ ? 1 : 0,
+        rim_->blur_sigma_, rim_->hsv_rotation_, rim_->hsv_saturation_, rim_->hsv_value_, trans_ ? 1 : 0,
+        do_whiten_ ? 1 : 0, flip_ ? 1 : 0, invert_ ? 1 : 0, fix_trans, rim_->source_opacity_, max_pix_,
+        render_backend->GetMaxTextureSize(), sokol);
+
+    return epi::MD5Hash((const uint8_t *)settings.data(), (unsigned int)settings.size()).ToString();
+}
+
+void ImageUploadJob::CalcUploadFlags()
+{
+    upload_flags_ = (clamp_ ? kUploadClamp : 0) | (mip_ ? kUploadMipMap : 0) | (smooth_ ? kUploadSmooth : 0) |
+                    ((info_.opacity == kOpacityMasked) ? kUploadThresh : 0);
+}
+
+void ImageUploadJob::Run()
+{
+    const Image *rim = rim_;
+
+    std::string cache_key;
+
+    if (ShouldDiskCache())
+    {
+        cache_key = DiskCacheKey();
+
+        ImageData *cached_img = ImageDiskCacheLoad(cache_key, &info_);
+
+        if (cached_img)
+        {
+            CalcUploadFlags();
+
+            result_ = cached_img;
+            return;
+        }
+    }
+
+    ImageData *tmp_img = source_img_;
+
+    source_img_ = nullptr;
+
+    bool is_empty = (info_.is_empty != 0);
+
+    if (!tmp_img)
+    {
+        tmp_img = DecodeImageSource(rim, source_data_, source_length_, &info_.opacity, &is_empty);
+
+        delete[] source_data_;
+        source_data_ = nullptr;
+
+        if (!tmp_img)
+            return;
+    }
+
+    if (rim->liquid_type_ > kLiquidImageNone &&
+        (swirling_flats == kLiquidSwirlSmmu || swirling_flats == kLiquidSwirlSmmuSlosh))
+    {
+        tmp_img->Swirl(swirl_tic_,
                        rim->liquid_type_); // Using leveltime disabled swirl
                                            // for intermission screens
     }
 
-    if (rim->opacity_ == kOpacityUnknown)
-        rim->opacity_ = DetermineOpacity(tmp_img, &rim->is_empty_);
+    if (info_.opacity == kOpacityUnknown)
+        info_.opacity = DetermineOpacity(tmp_img, &is_empty);
 
     if ((tmp_img->depth_ == 1) && IM_ShouldHQ2X(rim))
     {
-        bool solid = (rim->opacity_ == kOpacitySolid);
+        bool solid = (info_.opacity == kOpacitySolid);
 
-        HQ2xPaletteSetup(what_palette, solid ? -1 : kTransparentPixelIndex);
+        HQ2xPaletteSetup(&hq2x_palette, palette_, solid ? -1 : kTransparentPixelIndex);
 
-        ImageData *scaled_img = ImageHQ2x(tmp_img, solid, false /* invert */);
+        ImageData *scaled_img = ImageHQ2x(&hq2x_palette, tmp_img, solid, false /* invert */);
 
         if (rim->is_font_)
         {
             scaled_img->RemoveBackground();
-            rim->opacity_ = DetermineOpacity(tmp_img, &rim->is_empty_);
+            info_.opacity = DetermineOpacity(tmp_img, &is_empty);
         }
 
         if (rim->blur_sigma_ > 0.0f)
@@ -1356,12 +1562,12 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
     }
     else if (tmp_img->depth_ == 1)
     {
-        ImageData *rgb_img = RGBFromPalettised(tmp_img, what_palette, rim->opacity_);
+        ImageData *rgb_img = RGBFromPalettised(tmp_img, palette_, info_.opacity);
 
         if (rim->is_font_)
         {
             rgb_img->RemoveBackground();
-            rim->opacity_ = DetermineOpacity(tmp_img, &rim->is_empty_);
+            info_.opacity = DetermineOpacity(tmp_img, &is_empty);
         }
 
         if (rim->blur_sigma_ > 0.0f)
@@ -1379,7 +1585,7 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
         if (rim->is_font_)
         {
             tmp_img->RemoveBackground();
-            rim->opacity_ = DetermineOpacity(tmp_img, &rim->is_empty_);
+            info_.opacity = DetermineOpacity(tmp_img, &is_empty);
         }
         if (rim->blur_sigma_ > 0.0f)
         {
@@ -1387,21 +1593,23 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
             delete tmp_img;
             tmp_img = blurred_img;
         }
-        if (trans != nullptr)
-            PaletteRemapRGBA(tmp_img, what_palette, (const uint8_t *)&playpal_data[0]);
+        if (trans_ != nullptr)
+            PaletteRemapRGBA(tmp_img, palette_, (const uint8_t *)&playpal_data[0]);
     }
 
+    info_.is_empty = is_empty ? 1 : 0;
+
     if (rim->hsv_rotation_ || rim->hsv_saturation_ > -1 || rim->hsv_value_)
         tmp_img->SetHSV(rim->hsv_rotation_, rim->hsv_saturation_, rim->hsv_value_);
 
-    if (do_whiten)
+    if (do_whiten_)
         tmp_img->Whiten();
 
     // Need to flip or invert before checking image bounds.
-    if (flip)
+    if (flip_)
         tmp_img->Flip();
 
-    if (invert)
+    if (invert_)
         tmp_img->Invert();
 
     if (tmp_img->depth_ == 4 || (tmp_img->depth_ == 3 && rim->is_font_))
@@ -1411,29 +1619,53 @@ static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
         if (tmp_img->depth_ == 3)
             background = epi::MakeRGBA(tmp_img->pixels_[0], tmp_img->pixels_[1], tmp_img->pixels_[2]);
 
-        tmp_img->DetermineRealBounds(&rim->real_bottom_, &rim->real_left_, &rim->real_right_, &rim->real_top_,
+        tmp_img->DetermineRealBounds(&info_.real_bottom, &info_.real_left, &info_.real_right, &info_.real_top,
                                      background);
     }
     else
     {
-        rim->real_left_   = 0;
-        rim->real_bottom_ = 0;
-        rim->real_top_    = rim->height_;
-        rim->real_right_  = rim->width_;
+        info_.real_left   = 0;
+        info_.real_bottom = 0;
+        info_.real_top    = rim->height_;
+        info_.real_right  = rim->width_;
     }
 
-    GLuint tex_id =
-        UploadTexture(tmp_img,
-                      (clamp ? kUploadClamp : 0) | (mip ? kUploadMipMap : 0) | (smooth ? kUploadSmooth : 0) |
-                          ((rim->opacity_ == kOpacityMasked) ? kUploadThresh : 0),
-                      max_pix);
+    CalcUploadFlags();
 
-    delete tmp_img;
+    PrepareTextureForUpload(tmp_img, upload_flags_, max_pix_);
 
-    if (what_pal_cached)
-        delete[] what_palette;
+    if (!cache_key.empty())
+        ImageDiskCacheSave(cache_key, tmp_img, info_);
+
+    result_ = tmp_img;
+}
+
+static GLuint FinishImageUpload(ImageUploadJob *job)
+{
+    Image *rim = job->rim_;
+
+    if (!job->result_)
+        ImageSourceFailed(rim);
+
+    rim->opacity_     = job->info_.opacity;
+    rim->is_empty_    = (job->info_.is_empty != 0);
+    rim->real_bottom_ = job->info_.real_bottom;
+    rim->real_top_    = job->info_.real_top;
+    rim->real_left_   = job->info_.real_left;
+    rim->real_right_  = job->info_.real_right;
+
+    return UploadTexture(job->result_, job->upload_flags_, job->max_pix_);
+}
+
+static GLuint LoadImageOGL(Image *rim, const Colormap *trans, bool do_whiten)
+{
+    ImageUploadJob job;
+
+    SetupImageUpload(&job, rim, trans, do_whiten);
+
+    job.Run();
 
-    return tex_id;
+    return FinishImageUpload(&job);
 }
 
 //----------------------------------------------------------------------------
@@ -1794,7 +2026,9 @@ void ImageMakeSaveString(const Image *image, char *type, char *namebuf)
 //  IMAGE USAGE
 //
 
-static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whiten)
+static void FlushImageUploads(size_t keep);
+
+static CachedImage *FindCachedImage(Image *rim, const Colormap *trans, bool do_whiten)
 {
     // check if image + translation is already cached
 
@@ -1839,6 +2073,7 @@ static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whi
         rc->hue             = kRGBANoValue;
         rc->texture_id      = 0;
         rc->is_whitened     = do_whiten ? true : false;
+        rc->is_pending      = false;
 
         image_cache.push_back(rc);
 
@@ -1850,6 +2085,17 @@ static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whi
 
     EPI_ASSERT(rc);
 
+    return rc;
+}
+
+static CachedImage *ImageCacheOGL(Image *rim, const Colormap *trans, bool do_whiten)
+{
+    CachedImage *rc = FindCachedImage(rim, trans, do_whiten);
+
+    // needed right now, so finish off any queued uploads
+    if (rc->is_pending)
+        FlushImageUploads(0);
+
     if (rim->liquid_type_ > kLiquidImageNone &&
         (swirling_flats == kLiquidSwirlSmmu || swirling_flats == kLiquidSwirlSmmuSlosh))
     {
@@ -1898,9 +2144,111 @@ GLuint ImageCache(const Image *image, bool anim, const Colormap *trans, bool do_
     return rc->texture_id;
 }
 
+//
+// Threaded precaching.  Between BeginImagePrecache() and
+// FinishImagePrecache(), ImagePrecache() only queues the image: worker
+// threads decode and filter it, and the main thread uploads each one in
+// the order they were queued as soon as it is ready.  Only a limited
+// number are kept in flight, to bound the memory used by decoded images.
+//
+struct PendingImageUpload
+{
+    CachedImage    *cache;
+    ImageUploadJob *job;
+};
+
+static epi::WorkerPool               *image_workers = nullptr;
+static std::deque<PendingImageUpload> pending_uploads;
+static bool                           image_precaching = false;
+static size_t                         max_pending_uploads = 1;
+static int                            precache_count      = 0;
+static uint32_t                       precache_start_time = 0;
+
+static void FlushImageUploads(size_t keep)
+{
+    while (pending_uploads.size() > keep)
+    {
+        PendingImageUpload pend = pending_uploads.front();
+        pending_uploads.pop_front();
+
+        image_workers->Wait(pend.job);
+
+        pend.cache->texture_id = FinishImageUpload(pend.job);
+        pend.cache->is_pending = false;
+
+        delete pend.job;
+    }
+}
+
+void BeginImagePrecache(void)
+{
+    if (!image_threaded_precache.d_)
+        return;
+
+    if (!image_workers)
+    {
+        image_workers = new epi::WorkerPool();
+    }
+
+    // nothing to gain without any workers
+    if (image_workers->GetThreadCount() == 0)
+        return;
+
+    max_pending_uploads = 4 * image_workers->GetThreadCount();
+    image_precaching    = true;
+    precache_count      = 0;
+    precache_start_time = GetMicroseconds();
+}
+
+void FinishImagePrecache(void)
+{
+    if (!image_precaching)
+        return;
+
+    FlushImageUploads(0);
+
+    image_precaching = false;
+
+    LogDebug("Precached %d images in %d ms using %d threads\n", precache_count,
+             (int)((GetMicroseconds() - precache_start_time) / 1000), image_workers->GetThreadCount());
+}
+
+static void QueueImageUpload(Image *rim)
+{
+    // liquids re-swirl each tic, so leave them to ImageCache()
+    if (rim->liquid_type_ > kLiquidImageNone &&
+        (swirling_flats == kLiquidSwirlSmmu || swirling_flats == kLiquidSwirlSmmuSlosh))
+    {
+        ImageCache(rim, false);
+        return;
+    }
+
+    bool do_whiten = rim->grayscale_;
+
+    CachedImage *rc = FindCachedImage(rim, nullptr, do_whiten);
+
+    if (rc->texture_id != 0 || rc->is_pending)
+        return;
+
+    FlushImageUploads(max_pending_uploads - 1);
+
+    ImageUploadJob *job = new ImageUploadJob;
+
+    SetupImageUpload(job, rim, nullptr, do_whiten);
+
+    rc->is_pending = true;
+    pending_uploads.push_back({rc, job});
+    precache_count++;
+
+    image_workers->Add(job);
+}
+
 void ImagePrecache(const Image *image)
 {
-    ImageCache(image, false);
+    if (image_precaching)
+        QueueImageUpload((Image *)image);
+    else
+        ImageCache(image, false);
 
     // Intentional Const Override
     Image *rim = (Image *)image;
@@ -1915,11 +2263,55 @@ void ImagePrecache(const Image *image)
 
         const Image *alt = ImageContainerLookupInternal(real_textures, epi::StringHash(alt_name));
 
-        if (alt)
+        if (alt && image_precaching)
+            QueueImageUpload((Image *)alt);
+        else if (alt)
             ImageCache(alt, false);
     }
 }
 
+void ImageReadAllBlocks(std::vector<ImageData *> &blocks)
+{
+    ImageMap *buckets[4] = {&real_graphics, &real_textures, &real_flats, &real_sprites};
+
+    for (ImageMap *bucket : buckets)
+    {
+        for (auto mitr = bucket->begin(); mitr != bucket->end(); mitr++)
+        {
+            for (Image *rim : mitr->second)
+            {
+                bool palettised = false;
+
+                switch (rim->source_type_)
+                {
+                case kImageSourceFlat:
+                case kImageSourceTexture:
+                    palettised = true;
+                    break;
+
+                case kImageSourceGraphic:
+                case kImageSourceSprite:
+                    palettised = rim->source_graphic_.is_patch;
+                    break;
+
+                default:
+                    break;
+                }
+
+                if (!palettised)
+                    continue;
+
+                ImageData *img = ReadAsEpiBlock(rim);
+
+                if (img->depth_ == 1)
+                    blocks.push_back(img);
+                else
+                    delete img;
+            }
+        }
+    }
+}
+
 //----------------------------------------------------------------------------
 
 static void W_CreateDummyImages(void)
@@ -1960,6 +2352,9 @@ bool InitializeImages(void)
 
     W_CreateDummyImages();
 
+    ImageDiskCacheInit(epi::PathAppend(cache_directory, kImageCacheDirectory),
+                       (size_t)image_disk_cache_size.d_ * 1024 * 1024);
+
     return true;
 }
 
@@ -2003,7 +2398,14 @@ void DeleteAllImages(bool shutdown)
     // Delete images that should otherwise persist for the program lifetime
     if (shutdown)
     {
+        if (image_workers)
+        {
+            delete image_workers;
+            image_workers = nullptr;
+        }
+
         DeleteAllLightImages();
+        ClearTextureComposites();
         for (Font *font : hud_fonts)
         {
             if (font->definition_->type_ == kFontTypeTrueType)
@@ -2178,6 +2580,7 @@ void AnimateImageSet(const Image **images, int number, int speed)
             dupe_image->offset_x_       = rim->offset_x_;
             dupe_image->offset_y_       = rim->offset_y_;
             dupe_image->opacity_        = rim->opacity_;
+            dupe_image->source_opacity_ = rim->source_opacity_;
             dupe_image->scale_x_        = rim->scale_x_;
             dupe_image->scale_y_        = rim->scale_y_;
             dupe_image->source_graphic_  = rim->source_graphic_;
@@ -34,6 +34,7 @@
 #include "r_state.h"
 #include "w_epk.h"
 
+class ImageData;
 struct TextureDefinition;
 
 // the transparent pixel value we use
@@ -82,6 +83,10 @@ class Image
     // one of the kOpacityXXX values
     int opacity_;
 
+    // opacity_ as it was when the image was created, before any loading
+    // determined it (used in the image disk cache key)
+    int source_opacity_ = kOpacityUnknown;
+
     LiquidImageType liquid_type_;
 
     int swirled_game_tic_;
@@ -260,9 +265,17 @@ void CreateFallbackTexture(void);
 GLuint ImageCache(const Image *image, bool anim = true, const Colormap *trans = nullptr, bool do_whiten = false);
 void   ImagePrecache(const Image *image);
 
+// while active, ImagePrecache() decodes images on worker threads
+void BeginImagePrecache(void);
+void FinishImagePrecache(void);
+
 // this only needed during initialisation -- r_things.cpp
 const Image **GetUserSprites(int *count);
 
+// reads every palettised graphic, texture, flat and sprite without
+// uploading it, for -benchmark filters.  The caller deletes them.
+void ImageReadAllBlocks(std::vector<ImageData *> &blocks);
+
 // Store a duplicate version of the image_c with smoothing forced
 void StoreBlurredImage(const Image *image);
 
@@ -31,6 +31,7 @@
 #include <unordered_set>
 
 #include "AlmostEquals.h"
+#include "am_map.h"
 #include "dm_defs.h"
 #include "dm_state.h"
 #include "epi.h"
@@ -38,6 +39,7 @@
 #include "g_game.h"
 #include "i_defs_gl.h"
 #include "m_bbox.h"
+#include "m_profile.h"
 #include "n_network.h" // NetworkUpdate
 #include "p_local.h"
 #include "p_spec.h"
@@ -2030,6 +2032,8 @@ void UpdateSectorInterpolation(Sector *sector)
 //
 void RenderTrueBSP(void)
 {
+    EDGE_PROFILE_SCOPE("RenderTrueBSP");
+
     FuzzUpdate();
 
     ClearBSP();
@@ -2189,6 +2193,7 @@ void RenderTrueBSP(void)
         for (Line *li : newly_seen_lines)
         {
             li->flags |= kLineFlagMapped;
+            AutomapLineChanged(li);
         }
         newly_seen_lines.clear();
     }
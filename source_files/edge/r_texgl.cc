@@ -82,12 +82,8 @@ ImageData *RGBFromPalettised(ImageData *src, const uint8_t *palette, int opacity
         return src;
 }
 
-GLuint UploadTexture(ImageData *img, int flags, int max_pix)
+void PrepareTextureForUpload(ImageData *img, int flags, int max_pix)
 {
-    /* Send the texture data to the GL, and returns the texture ID
-     * assigned to it.
-     */
-
 #ifdef EDGE_SOKOL
     // Only OpenGL supports RGB format for textures, so promote to RGBA
     if (img->depth_ == 3)
@@ -98,10 +94,6 @@ GLuint UploadTexture(ImageData *img, int flags, int max_pix)
 
     EPI_ASSERT(img->depth_ == 3 || img->depth_ == 4);
 
-    bool clamp  = (flags & kUploadClamp) ? true : false;
-    bool nomip  = (flags & kUploadMipMap) ? false : true;
-    bool smooth = (flags & kUploadSmooth) ? true : false;
-
     int total_w = img->width_;
     int total_h = img->height_;
 
@@ -124,6 +116,30 @@ GLuint UploadTexture(ImageData *img, int flags, int max_pix)
             new_w /= 2;
     }
 
+    if (img->width_ != new_w || img->height_ != new_h)
+    {
+        img->ShrinkMasked(new_w, new_h);
+
+        if (flags & kUploadThresh)
+            img->ThresholdAlpha(144);
+    }
+}
+
+GLuint UploadTexture(ImageData *img, int flags, int max_pix)
+{
+    /* Send the texture data to the GL, and returns the texture ID
+     * assigned to it.
+     */
+
+    PrepareTextureForUpload(img, flags, max_pix);
+
+    bool clamp  = (flags & kUploadClamp) ? true : false;
+    bool nomip  = (flags & kUploadMipMap) ? false : true;
+    bool smooth = (flags & kUploadSmooth) ? true : false;
+
+    int new_w = img->width_;
+    int new_h = img->height_;
+
     render_state->PixelStorei(GL_UNPACK_ALIGNMENT, 1);
 
     GLuint id;
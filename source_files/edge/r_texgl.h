@@ -33,6 +33,11 @@ enum TextureUploadFlag
 
 GLuint UploadTexture(ImageData *img, int flags = kUploadNone, int max_pix = (1 << 30));
 
+// Does the CPU-side part of UploadTexture() (format promotion and
+// shrinking to the texture size limits) without touching the GL, so
+// it may be done on a worker thread ahead of the actual upload.
+void PrepareTextureForUpload(ImageData *img, int flags = kUploadNone, int max_pix = (1 << 30));
+
 ImageData *RGBFromPalettised(ImageData *src, const uint8_t *palette, int opacity);
 
 void PaletteRemapRGBA(const ImageData *img, const uint8_t *new_pal, const uint8_t *old_pal);
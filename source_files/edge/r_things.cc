@@ -64,7 +64,6 @@
 #include "w_sprite.h"
 
 extern coal::VM *ui_vm;
-extern double    COALGetFloat(coal::VM *vm, const char *mod_name, const char *var_name);
 extern bool erraticism_active;
 
 EDGE_DEFINE_CONSOLE_VARIABLE(crosshair_image, "None", kConsoleVariableFlagArchive)
@@ -404,7 +403,7 @@ static void RenderPSprite(PlayerSprite *psp, int which, Player *player, RegionPr
     {
         // Lobo 2022: Apply sprite Y offset, mainly for Heretic weapons.
         if ((state->flags & kStateFrameFlagWeapon) && (player->ready_weapon_ >= 0))
-            ty1 += COALGetFloat(ui_vm, "hud", "universal_y_adjust") +
+            ty1 += COALGetFloat(ui_vm, coal_hud_universal_y_adjust) +
                    player->weapons_[player->ready_weapon_].info->y_adjust_;
     }
 
@@ -811,7 +810,7 @@ void RenderWeaponModel(Player *p)
     }
     else
     {
-        bias = COALGetFloat(ui_vm, "hud", "universal_y_adjust") + p->weapons_[p->ready_weapon_].info->y_adjust_;
+        bias = COALGetFloat(ui_vm, coal_hud_universal_y_adjust) + p->weapons_[p->ready_weapon_].info->y_adjust_;
     }
 
     bias /= 5;
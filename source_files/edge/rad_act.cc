@@ -1479,7 +1479,7 @@ void P_ActReplace(MapObject *mo, const MapObjectDefinition *newThing)
 
     // UnsetThingPosition(mo);
     {
-        mo->info_ = newThing;
+        SetMapObjectType(mo, newThing);
 
         mo->radius_ = mo->info_->radius_;
         mo->height_ = mo->info_->height_;
@@ -762,6 +762,13 @@ struct RADScriptTrigger
 
     // prevent repeating scripts from clogging the console
     const char *last_con_message = nullptr;
+
+    // slot in the trigger index (i.e. position in the list when the
+    // index was built), or -1.  See RunScriptTriggers().
+    int index = -1;
+
+    // in the index grid: only runs when a player is near it
+    bool spatial = false;
 };
 
 //
@@ -2385,16 +2385,12 @@ static const RADScriptParser radtrig_parsers[] = {
     // that's all, folks.
     {0, nullptr, 0, 0, nullptr}};
 
-void ScriptParseLine()
+//
+// Invoke the parser for the primitive named by pars[0].  Frees the
+// parameters.
+//
+static void ScriptParsePrimitive(std::vector<const char *> &pars)
 {
-    std::vector<const char *> pars;
-
-    ScriptTokenizeLine(pars);
-
-    // simply ignore blank lines
-    if (pars.empty())
-        return;
-
     for (const RADScriptParser *cur = radtrig_parsers; cur->name != nullptr; cur++)
     {
         const char *cur_name = cur->name;
@@ -2434,6 +2430,58 @@ void ScriptParseLine()
     ScriptFreeParameters(pars);
 }
 
+void ScriptParseLine()
+{
+    std::vector<const char *> pars;
+
+    ScriptTokenizeLine(pars);
+
+    // simply ignore blank lines
+    if (pars.empty())
+        return;
+
+    if (ddf_token_record != nullptr)
+    {
+        ddf_token_record->PutInt(current_script_line_number);
+        ddf_token_record->PutInt((int)pars.size());
+
+        for (const char *par : pars)
+            ddf_token_record->PutString(par);
+    }
+
+    ScriptParsePrimitive(pars);
+}
+
+//
+// Feed the lines recorded by ScriptParseLine() back to the parsers, in
+// place of reading the text.
+//
+static void ScriptReplayLines()
+{
+    std::vector<const char *> pars;
+
+    // only the line numbers were kept
+    current_script_line.clear();
+
+    for (;;)
+    {
+        current_script_line_number = ddf_token_replay->GetInt();
+
+        // line numbers start at 1
+        if (current_script_line_number == 0)
+            break;
+
+        int count = ddf_token_replay->GetInt();
+
+        pars.clear();
+
+        for (int i = 0; i < count; i++)
+            pars.push_back(epi::CStringDuplicate(ddf_token_replay->GetString()));
+
+        ScriptParsePrimitive(pars);
+    }
+}
+
 //----------------------------------------------------------------------------
 
 static int ReadScriptLine(const std::string &data, size_t &pos, std::string &out_line)
@@ -2504,6 +2552,14 @@ void ReadRADScript(const std::string &data, const std::string &source)
     current_script_line_number = 1;
     current_script_level       = 0;
 
+    // a recorded parse of this same text is being fed back
+    if (ddf_token_replay != nullptr)
+    {
+        ScriptReplayLines();
+        ScriptParserDone();
+        return;
+    }
+
     size_t pos = 0;
 
     for (;;)
@@ -2521,6 +2577,9 @@ void ReadRADScript(const std::string &data, const std::string &source)
         current_script_line_number += real_num;
     }
 
+    if (ddf_token_record != nullptr)
+        ddf_token_record->PutInt(0);
+
     ScriptParserDone();
 }
 
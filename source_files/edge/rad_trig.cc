@@ -34,6 +34,10 @@
 
 #include "rad_trig.h"
 
+#include <algorithm>
+#include <vector>
+
+#include "HandmadeMath.h"
 #include "am_map.h"
 #include "dm_defs.h"
 #include "dm_state.h"
@@ -51,6 +55,7 @@
 #include "m_argv.h"
 #include "m_menu.h"
 #include "m_misc.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "p_local.h"
 #include "p_spec.h"
@@ -526,10 +531,6 @@ static int ScriptAllPlayersCheckCondition(RADScript *r, int mask)
 
 static bool ScriptCheckBossTrigger(ScriptOnDeathParameter *cond)
 {
-    MapObject *mo;
-
-    int count = 0;
-
     // lookup thing type if we haven't already done so
     if (!cond->cached_info)
     {
@@ -544,13 +545,15 @@ static bool ScriptCheckBossTrigger(ScriptOnDeathParameter *cond)
         }
     }
 
-    // scan the remaining mobjs to see if all bosses are dead
-    for (mo = map_object_list_head; mo != nullptr; mo = mo->next_)
-    {
-        if (seen_monsters.count(cond->cached_info) == 0)
-            return false; // Never on map?
+    if (map_object_list_head != nullptr && seen_monsters.count(cond->cached_info) == 0)
+        return false; // Never on map?
+
+    // scan the remaining mobjs of this type to see if all bosses are dead
+    int count = 0;
 
-        if (mo->info_ == cond->cached_info && mo->health_ > 0)
+    for (MapObject *mo = FirstMapObjectOfType(cond->cached_info); mo != nullptr; mo = mo->type_next_)
+    {
+        if (mo->health_ > 0)
         {
             count++;
 
@@ -646,8 +649,293 @@ bool ScriptUpdatePath(MapObject *thing)
     return true;
 }
 
+//
+// Trigger index.
+//
+// Most triggers in a big RTS mod are plain radius triggers, and only do
+// anything while a player is inside them.  Those are put in a uniform
+// grid, so RunScriptTriggers() only looks at the ones in the players'
+// cells.  Everything else (immediate, sector based and unbounded
+// triggers) is always run, as are radius triggers that have to keep
+// going on their own: independent ones once activated, and ones counting
+// down a repeat delay.
+//
+// Slots are in active_triggers order, which is the order triggers have
+// always been run in.  The index is rebuilt lazily whenever the trigger
+// list is replaced (new level, loaded game).
+//
+static constexpr float kScriptGridCellSize     = 512.0f;
+static constexpr int   kScriptGridMaximumCells = 65536;
+static constexpr int   kScriptGridMaximumSpan  = 64; // cells, before a trigger is just always run
+
+struct ScriptTriggerIndex
+{
+    bool valid = false;
+
+    std::vector<RADScriptTrigger *> table; // nullptr once removed
+
+    std::vector<int> always;
+    std::vector<int> pinned;
+
+    float origin_x  = 0;
+    float origin_y  = 0;
+    float cell_size = kScriptGridCellSize;
+    int   width     = 0;
+    int   height    = 0;
+
+    // cell c holds items[cell_start[c] .. cell_start[c+1]-1]
+    std::vector<int> cell_start;
+    std::vector<int> items;
+
+    std::vector<int> candidates;
+};
+
+static ScriptTriggerIndex trigger_index;
+
+static bool ScriptTriggerIsSpatial(const RADScript *r)
+{
+    if (r->tagged_immediate)
+        return false;
+
+    if (r->sector_tag > 0)
+        return false;
+
+    if (r->sector_index >= 0 && r->sector_index <= total_level_sectors)
+        return false;
+
+    return r->rad_x >= 0 && r->rad_y >= 0;
+}
+
+// radius triggers which must run even with no player near them
+static bool ScriptTriggerNeedsPin(const RADScriptTrigger *trig)
+{
+    return trig->repeat_delay > 0 || (trig->info->tagged_independent && trig->activated);
+}
+
+static void ScriptGridCellRange(float x1, float y1, float x2, float y2, int *cx1, int *cy1, int *cx2, int *cy2)
+{
+    const ScriptTriggerIndex &ti = trigger_index;
+
+    *cx1 = HMM_Clamp(0, (int)floorf((x1 - ti.origin_x) / ti.cell_size), ti.width - 1);
+    *cy1 = HMM_Clamp(0, (int)floorf((y1 - ti.origin_y) / ti.cell_size), ti.height - 1);
+    *cx2 = HMM_Clamp(0, (int)floorf((x2 - ti.origin_x) / ti.cell_size), ti.width - 1);
+    *cy2 = HMM_Clamp(0, (int)floorf((y2 - ti.origin_y) / ti.cell_size), ti.height - 1);
+}
+
+static void IndexScriptTriggers(void)
+{
+    ScriptTriggerIndex &ti = trigger_index;
+
+    ti.table.clear();
+    ti.always.clear();
+    ti.pinned.clear();
+    ti.cell_start.clear();
+    ti.items.clear();
+
+    float min_x = 0, min_y = 0, max_x = 0, max_y = 0;
+    bool  any_spatial = false;
+
+    for (RADScriptTrigger *trig = active_triggers; trig; trig = trig->next)
+    {
+        trig->index   = (int)ti.table.size();
+        trig->spatial = ScriptTriggerIsSpatial(trig->info);
+
+        ti.table.push_back(trig);
+
+        if (!trig->spatial)
+            continue;
+
+        const RADScript *r = trig->info;
+
+        if (!any_spatial)
+        {
+            min_x = r->x - r->rad_x;
+            min_y = r->y - r->rad_y;
+            max_x = r->x + r->rad_x;
+            max_y = r->y + r->rad_y;
+        }
+        else
+        {
+            min_x = HMM_MIN(min_x, r->x - r->rad_x);
+            min_y = HMM_MIN(min_y, r->y - r->rad_y);
+            max_x = HMM_MAX(max_x, r->x + r->rad_x);
+            max_y = HMM_MAX(max_y, r->y + r->rad_y);
+        }
+
+        any_spatial = true;
+    }
+
+    ti.valid = true;
+
+    ti.cell_size = kScriptGridCellSize;
+
+    for (;;)
+    {
+        ti.width  = any_spatial ? (int)((max_x - min_x) / ti.cell_size) + 1 : 1;
+        ti.height = any_spatial ? (int)((max_y - min_y) / ti.cell_size) + 1 : 1;
+
+        if (ti.width * ti.height <= kScriptGridMaximumCells)
+            break;
+
+        ti.cell_size *= 2;
+    }
+
+    ti.origin_x = min_x;
+    ti.origin_y = min_y;
+
+    int total_cells = ti.width * ti.height;
+
+    ti.cell_start.assign(total_cells + 1, 0);
+
+    // two passes: count per cell, then fill
+    for (int pass = 0; pass < 2; pass++)
+    {
+        std::vector<int> fill;
+
+        if (pass == 1)
+        {
+            for (int c = 0; c < total_cells; c++)
+                ti.cell_start[c + 1] += ti.cell_start[c];
+
+            ti.items.resize(ti.cell_start[total_cells]);
+            fill.assign(ti.cell_start.begin(), ti.cell_start.end() - 1);
+        }
+
+        for (RADScriptTrigger *trig : ti.table)
+        {
+            if (!trig->spatial)
+            {
+                if (pass == 0)
+                    ti.always.push_back(trig->index);
+                continue;
+            }
+
+            const RADScript *r = trig->info;
+
+            int cx1, cy1, cx2, cy2;
+            ScriptGridCellRange(r->x - r->rad_x, r->y - r->rad_y, r->x + r->rad_x, r->y + r->rad_y, &cx1, &cy1,
+                                &cx2, &cy2);
+
+            // huge triggers are cheaper to just test every tic
+            if ((cx2 - cx1 + 1) * (cy2 - cy1 + 1) > kScriptGridMaximumSpan)
+            {
+                if (pass == 0)
+                {
+                    trig->spatial = false;
+                    ti.always.push_back(trig->index);
+                }
+                continue;
+            }
+
+            if (pass == 0 && ScriptTriggerNeedsPin(trig))
+                ti.pinned.push_back(trig->index);
+
+            for (int cy = cy1; cy <= cy2; cy++)
+            {
+                for (int cx = cx1; cx <= cx2; cx++)
+                {
+                    int c = cy * ti.width + cx;
+
+                    if (pass == 0)
+                        ti.cell_start[c + 1]++;
+                    else
+                        ti.items[fill[c]++] = trig->index;
+                }
+            }
+        }
+    }
+
+    LogDebug("IndexScriptTriggers: %d triggers, %d always run, %d in a %dx%d grid\n", (int)ti.table.size(),
+             (int)ti.always.size(), (int)(ti.table.size() - ti.always.size()), ti.width, ti.height);
+}
+
+static void ClearScriptTriggerIndex(void)
+{
+    ScriptTriggerIndex &ti = trigger_index;
+
+    ti.valid = false;
+
+    ti.table.clear();
+    ti.always.clear();
+    ti.pinned.clear();
+    ti.cell_start.clear();
+    ti.items.clear();
+    ti.candidates.clear();
+}
+
+// Collects the slots of every trigger that may do something this tic,
+// in list order.
+static void GatherScriptTriggers(void)
+{
+    ScriptTriggerIndex &ti = trigger_index;
+
+    ti.candidates.clear();
+
+    for (int idx : ti.always)
+    {
+        if (ti.table[idx])
+            ti.candidates.push_back(idx);
+    }
+
+    for (int idx : ti.pinned)
+    {
+        if (ti.table[idx])
+            ti.candidates.push_back(idx);
+    }
+
+    if (!ti.items.empty())
+    {
+        for (int pnum = 0; pnum < kMaximumPlayers; pnum++)
+        {
+            Player *p = players[pnum];
+
+            if (!p || !p->map_object_)
+                continue;
+
+            const MapObject *mo = p->map_object_;
+
+            int cx1, cy1, cx2, cy2;
+            ScriptGridCellRange(mo->x - mo->radius_, mo->y - mo->radius_, mo->x + mo->radius_, mo->y + mo->radius_,
+                                &cx1, &cy1, &cx2, &cy2);
+
+            // completely outside the grid?
+            if (mo->x + mo->radius_ < ti.origin_x || mo->y + mo->radius_ < ti.origin_y ||
+                mo->x - mo->radius_ > ti.origin_x + ti.width * ti.cell_size ||
+                mo->y - mo->radius_ > ti.origin_y + ti.height * ti.cell_size)
+                continue;
+
+            for (int cy = cy1; cy <= cy2; cy++)
+            {
+                for (int cx = cx1; cx <= cx2; cx++)
+                {
+                    int c = cy * ti.width + cx;
+
+                    for (int i = ti.cell_start[c]; i < ti.cell_start[c + 1]; i++)
+                    {
+                        if (ti.table[ti.items[i]])
+                            ti.candidates.push_back(ti.items[i]);
+                    }
+                }
+            }
+        }
+    }
+
+    std::sort(ti.candidates.begin(), ti.candidates.end());
+    ti.candidates.erase(std::unique(ti.candidates.begin(), ti.candidates.end()), ti.candidates.end());
+
+    // drop removed triggers from the always list now and then
+    if (ti.always.size() > 64 && ti.always.size() > ti.candidates.size() * 2)
+    {
+        ti.always.erase(std::remove_if(ti.always.begin(), ti.always.end(), [&](int idx) { return !ti.table[idx]; }),
+                        ti.always.end());
+    }
+}
+
 static void DoRemoveTrigger(RADScriptTrigger *trig)
 {
+    if (trig->index >= 0 && trig->index < (int)trigger_index.table.size())
+        trigger_index.table[trig->index] = nullptr;
+
     // handle tag linkage
     if (trig->tag_next)
         trig->tag_next->tag_previous = trig->tag_previous;
@@ -670,151 +958,179 @@ static void DoRemoveTrigger(RADScriptTrigger *trig)
 }
 
 //
-// Radius Trigger Event handler.
+// Runs one trigger for this tic.  Returns false if it finished and was
+// removed.
 //
-void RunScriptTriggers(void)
+static bool RunScriptTrigger(RADScriptTrigger *trig)
 {
-    RADScriptTrigger *trig, *next;
+    // Don't process, if disabled
+    if (trig->disabled)
+        return true;
 
-    // Start looking through the trigger list.
-    for (trig = active_triggers; trig; trig = next)
+    // Handle repeat delay (from TAGGED_REPEATABLE).  This must be
+    // done *before* all the condition checks, and that's what makes
+    // it different from `wait_tics'.
+    //
+    if (trig->repeat_delay > 0)
     {
-        next = trig->next;
+        trig->repeat_delay--;
+        return true;
+    }
 
-        // stop running all triggers when an RTS menu becomes active
-        if (rts_menu_active)
-            break;
+    // Independent, means you don't have to stay within the trigger
+    // radius for it to operate, It will operate on it's own.
 
-        // Don't process, if disabled
-        if (trig->disabled)
-            continue;
+    if (!(trig->info->tagged_independent && trig->activated))
+    {
+        int mask = ScriptAlivePlayers();
 
-        // Handle repeat delay (from TAGGED_REPEATABLE).  This must be
-        // done *before* all the condition checks, and that's what makes
-        // it different from `wait_tics'.
+        // Immediate triggers are just that. Immediate.
+        // Not within range so skip it.
         //
-        if (trig->repeat_delay > 0)
+        if (!trig->info->tagged_immediate)
         {
-            trig->repeat_delay--;
-            continue;
+            mask = ScriptAllPlayersInRadius(trig->info, mask);
+            if (mask == 0)
+                return true;
         }
 
-        // Independent, means you don't have to stay within the trigger
-        // radius for it to operate, It will operate on it's own.
-
-        if (!(trig->info->tagged_independent && trig->activated))
+        // Check for use key trigger.
+        if (trig->info->tagged_use)
         {
-            int mask = ScriptAlivePlayers();
+            mask = ScriptAllPlayersUsing(mask);
+            if (mask == 0)
+                return true;
+        }
 
-            // Immediate triggers are just that. Immediate.
-            // Not within range so skip it.
-            //
-            if (!trig->info->tagged_immediate)
-            {
-                mask = ScriptAllPlayersInRadius(trig->info, mask);
-                if (mask == 0)
-                    continue;
-            }
+        // height check...
+        if (trig->info->height_trig)
+        {
+            ScriptOnHeightParameter *cur;
 
-            // Check for use key trigger.
-            if (trig->info->tagged_use)
-            {
-                mask = ScriptAllPlayersUsing(mask);
-                if (mask == 0)
-                    continue;
-            }
+            for (cur = trig->info->height_trig; cur; cur = cur->next)
+                if (!ScriptCheckHeightTrigger(trig, cur))
+                    break;
 
-            // height check...
-            if (trig->info->height_trig)
-            {
-                ScriptOnHeightParameter *cur;
+            // if they all succeeded, then cur will be nullptr...
+            if (cur)
+                return true;
+        }
 
-                for (cur = trig->info->height_trig; cur; cur = cur->next)
-                    if (!ScriptCheckHeightTrigger(trig, cur))
-                        break;
+        // ondeath check...
+        if (trig->info->boss_trig)
+        {
+            ScriptOnDeathParameter *cur;
 
-                // if they all succeeded, then cur will be nullptr...
-                if (cur)
-                    continue;
-            }
+            for (cur = trig->info->boss_trig; cur; cur = cur->next)
+                if (!ScriptCheckBossTrigger(cur))
+                    break;
 
-            // ondeath check...
-            if (trig->info->boss_trig)
-            {
-                ScriptOnDeathParameter *cur;
+            // if they all succeeded, then cur will be nullptr...
+            if (cur)
+                return true;
+        }
 
-                for (cur = trig->info->boss_trig; cur; cur = cur->next)
-                    if (!ScriptCheckBossTrigger(cur))
-                        break;
+        // condition check...
+        if (trig->info->cond_trig)
+        {
+            mask = ScriptAllPlayersCheckCondition(trig->info, mask);
+            if (mask == 0)
+                return true;
+        }
 
-                // if they all succeeded, then cur will be nullptr...
-                if (cur)
-                    continue;
-            }
+        trig->activated    = true;
+        trig->acti_players = mask;
+    }
 
-            // condition check...
-            if (trig->info->cond_trig)
-            {
-                mask = ScriptAllPlayersCheckCondition(trig->info, mask);
-                if (mask == 0)
-                    continue;
-            }
+    // If we are waiting, decrement count and skip it.
+    // Note that we must do this *after* all the condition checks.
+    //
+    if (trig->wait_tics > 0)
+    {
+        trig->wait_tics--;
+        return true;
+    }
 
-            trig->activated    = true;
-            trig->acti_players = mask;
-        }
+    // Waiting until monsters are dead?
+    while (trig->wait_tics == 0 && trig->wud_count <= 0)
+    {
+        // Execute current command
+        RADScriptState *state = trig->state;
+        EPI_ASSERT(state);
 
-        // If we are waiting, decrement count and skip it.
-        // Note that we must do this *after* all the condition checks.
+        // move to next state.  We do this NOW since the action itself
+        // may want to change the trigger's state (to support GOTO type
+        // actions and other possibilities).
         //
-        if (trig->wait_tics > 0)
-        {
-            trig->wait_tics--;
-            continue;
-        }
+        trig->state = trig->state->next;
 
-        // Waiting until monsters are dead?
-        while (trig->wait_tics == 0 && trig->wud_count <= 0)
-        {
-            // Execute current command
-            RADScriptState *state = trig->state;
-            EPI_ASSERT(state);
+        (*state->action)(trig, state->param);
 
-            // move to next state.  We do this NOW since the action itself
-            // may want to change the trigger's state (to support GOTO type
-            // actions and other possibilities).
-            //
-            trig->state = trig->state->next;
+        if (!trig->state)
+            break;
 
-            (*state->action)(trig, state->param);
+        trig->wait_tics += trig->state->tics;
 
-            if (!trig->state)
-                break;
+        if (trig->disabled || rts_menu_active)
+            break;
+    }
 
-            trig->wait_tics += trig->state->tics;
+    if (trig->state)
+        return true;
 
-            if (trig->disabled || rts_menu_active)
-                break;
-        }
+    // we've reached the end of the states.  Delete the trigger unless
+    // it is Tagged_Repeatable and has some more repeats left.
+    //
+    if (trig->info->repeat_count != 0)
+        trig->repeats_left--;
 
-        if (trig->state)
-            continue;
+    if (trig->repeats_left > 0)
+    {
+        trig->state        = trig->info->first_state;
+        trig->wait_tics    = trig->state->tics;
+        trig->repeat_delay = trig->info->repeat_delay;
+        return true;
+    }
 
-        // we've reached the end of the states.  Delete the trigger unless
-        // it is Tagged_Repeatable and has some more repeats left.
-        //
-        if (trig->info->repeat_count != 0)
-            trig->repeats_left--;
+    DoRemoveTrigger(trig);
+    return false;
+}
 
-        if (trig->repeats_left > 0)
+//
+// Radius Trigger Event handler.
+//
+void RunScriptTriggers(void)
+{
+    EDGE_PROFILE_SCOPE("RunScriptTriggers");
+
+    ScriptTriggerIndex &ti = trigger_index;
+
+    if (!ti.valid)
+        IndexScriptTriggers();
+
+    GatherScriptTriggers();
+
+    ti.pinned.clear();
+
+    // Start looking through the trigger list.
+    for (int idx : ti.candidates)
+    {
+        RADScriptTrigger *trig = ti.table[idx];
+
+        // stop running all triggers when an RTS menu becomes active
+        if (rts_menu_active)
         {
-            trig->state        = trig->info->first_state;
-            trig->wait_tics    = trig->state->tics;
-            trig->repeat_delay = trig->info->repeat_delay;
+            // keep the rest running next tic
+            if (trig && trig->spatial && ScriptTriggerNeedsPin(trig))
+                ti.pinned.push_back(idx);
             continue;
         }
 
-        DoRemoveTrigger(trig);
+        if (!trig || !RunScriptTrigger(trig))
+            continue;
+
+        if (trig->spatial && ScriptTriggerNeedsPin(trig))
+            ti.pinned.push_back(idx);
     }
 }
 
@@ -963,6 +1279,7 @@ void ClearScriptTriggers(void)
         delete trig;
     }
 
+    ClearScriptTriggerIndex();
     ScriptClearCachedInfo();
     ResetScriptTips();
 }
@@ -30,6 +30,7 @@
 #include "i_defs_gl.h"
 #include "im_data.h"
 #include "m_argv.h"
+#include "m_profile.h"
 #include "r_backend.h"
 #include "r_colormap.h"
 #include "r_gldefs.h"
@@ -282,6 +283,8 @@ static void RenderFlush()
 //
 void RenderCurrentUnits(void)
 {
+    EDGE_PROFILE_SCOPE("RenderCurrentUnits");
+
     if (render_backend->RenderUnitsLocked())
     {
         FatalError("RenderCurrentUnits - Render units are locked");
@@ -25,13 +25,16 @@
 
 #include "s_blit.h"
 
+#include <atomic>
 #include <list>
 
 #include "AlmostEquals.h"
+#include "HandmadeMath.h"
 #include "con_var.h"
 #include "dm_state.h"
 #include "epi.h"
 #include "epi_sdl.h"
+#include "i_pacing.h"
 #include "i_sound.h"
 #include "i_system.h"
 #include "m_misc.h"
@@ -62,11 +65,57 @@ BAMAngle listen_angle;
 
 extern int sound_device_frequency;
 
-SoundChannel::SoundChannel() : state_(kChannelEmpty), data_(nullptr), definition_(nullptr), position_(nullptr)
+enum SoundCommandType
+{
+    kSoundCommandStart = 0,
+    kSoundCommandStop,
+    kSoundCommandLoop,
+    kSoundCommandPosition,      // position_, value_ = min distance (if > 0)
+    kSoundCommandListener,      // position_, direction_
+    kSoundCommandEffectVolume,  // value_
+};
+
+struct SoundCommand
+{
+    SoundCommandType type_;
+    ma_sound        *sound_;
+
+    float position_[3];
+    float direction_[3];
+    float value_;
+};
+
+// must be a power of two.  One tic posts at most a start and a position
+// per channel plus the listener, so this is several tics' worth.
+static constexpr uint32_t kSoundCommandQueueSize = 1024;
+
+static SoundCommand sound_commands[kSoundCommandQueueSize];
+
+// free-running counters; head is only written by the game thread and
+// tail only by the audio thread.
+static std::atomic<uint32_t> sound_command_head{0};
+static std::atomic<uint32_t> sound_command_tail{0};
+
+static SoundVoice sound_voices[kMaximumSoundVoices];
+
+struct SoundQueueStats
+{
+    uint32_t posted;
+    uint32_t dropped;
+    uint32_t max_depth;
+    int      voices_waiting; // allocations that found no free voice
+
+    uint64_t tic_time;
+    uint64_t last_tic_time;
+    uint64_t worst_tic_time;
+    uint64_t worst_call_time;
+};
+
+static SoundQueueStats sound_queue_stats;
+
+SoundChannel::SoundChannel()
+    : state_(kChannelEmpty), data_(nullptr), definition_(nullptr), position_(nullptr), voice_(nullptr)
 {
-    EPI_CLEAR_MEMORY(&channel_sound_, ma_sound, 1);
-    EPI_CLEAR_MEMORY(&ref_config_, ma_audio_buffer_config, 1);
-    EPI_CLEAR_MEMORY(&ref_, ma_audio_buffer, 1);
 }
 
 SoundChannel::~SoundChannel()
@@ -75,6 +124,179 @@ SoundChannel::~SoundChannel()
 
 //----------------------------------------------------------------------------
 
+SoundAudioCallTimer::SoundAudioCallTimer() : start_(PacingGetNanoseconds())
+{
+}
+
+SoundAudioCallTimer::~SoundAudioCallTimer()
+{
+    uint64_t elapsed = PacingGetNanoseconds() - start_;
+
+    sound_queue_stats.tic_time += elapsed;
+    sound_queue_stats.worst_call_time = HMM_MAX(sound_queue_stats.worst_call_time, elapsed);
+}
+
+// true once the audio thread has applied everything up to `position`
+static bool SoundCommandApplied(uint32_t position)
+{
+    return (int32_t)(sound_command_tail.load(std::memory_order_acquire) - position) >= 0;
+}
+
+static bool PostSoundCommand(const SoundCommand &cmd, SoundVoice *voice)
+{
+    uint32_t head  = sound_command_head.load(std::memory_order_relaxed);
+    uint32_t depth = head - sound_command_tail.load(std::memory_order_acquire);
+
+    // never wait on the audio thread.  If it has stalled this long,
+    // nothing can be heard anyway.
+    if (depth >= kSoundCommandQueueSize)
+    {
+        sound_queue_stats.dropped++;
+        return false;
+    }
+
+    sound_commands[head & (kSoundCommandQueueSize - 1)] = cmd;
+    sound_command_head.store(head + 1, std::memory_order_release);
+
+    if (voice)
+        voice->last_command_ = head + 1;
+
+    sound_queue_stats.posted++;
+    sound_queue_stats.max_depth = HMM_MAX(sound_queue_stats.max_depth, depth + 1);
+
+    return true;
+}
+
+static bool PostVoiceCommand(SoundCommandType type, SoundVoice *voice)
+{
+    SoundCommand cmd;
+    EPI_CLEAR_MEMORY(&cmd, SoundCommand, 1);
+
+    cmd.type_  = type;
+    cmd.sound_ = &voice->sound_;
+
+    return PostSoundCommand(cmd, voice);
+}
+
+void ProcessSoundCommands(void *user_data, float *frames_out, ma_uint64 frame_count)
+{
+    EPI_UNUSED(user_data);
+    EPI_UNUSED(frames_out);
+    EPI_UNUSED(frame_count);
+
+    uint32_t tail = sound_command_tail.load(std::memory_order_relaxed);
+    uint32_t head = sound_command_head.load(std::memory_order_acquire);
+
+    for (; tail != head; tail++)
+    {
+        const SoundCommand &cmd = sound_commands[tail & (kSoundCommandQueueSize - 1)];
+
+        switch (cmd.type_)
+        {
+        case kSoundCommandStart:
+            ma_sound_start(cmd.sound_);
+            break;
+
+        case kSoundCommandStop:
+            ma_sound_stop(cmd.sound_);
+            break;
+
+        case kSoundCommandLoop:
+            ma_sound_set_looping(cmd.sound_, MA_TRUE);
+            break;
+
+        case kSoundCommandPosition:
+            ma_sound_set_position(cmd.sound_, cmd.position_[0], cmd.position_[1], cmd.position_[2]);
+            if (cmd.value_ > 0)
+                ma_sound_set_min_distance(cmd.sound_, cmd.value_);
+            break;
+
+        case kSoundCommandListener:
+            ma_engine_listener_set_position(&sound_engine, 0, cmd.position_[0], cmd.position_[1], cmd.position_[2]);
+            ma_engine_listener_set_direction(&sound_engine, 0, cmd.direction_[0], cmd.direction_[1],
+                                             cmd.direction_[2]);
+            break;
+
+        case kSoundCommandEffectVolume:
+            ma_sound_group_set_volume(&sfx_node, cmd.value_);
+            break;
+        }
+    }
+
+    sound_command_tail.store(tail, std::memory_order_release);
+}
+
+static void UninitSoundVoice(SoundVoice *voice)
+{
+    {
+        SoundAudioCallTimer timer;
+
+        ma_sound_uninit(&voice->sound_);
+        ma_audio_buffer_uninit(&voice->buffer_);
+    }
+
+    voice->in_use_  = false;
+    voice->retired_ = false;
+}
+
+// Gives back retired voices the audio thread is done with.
+static void RecycleSoundVoices(void)
+{
+    for (int i = 0; i < kMaximumSoundVoices; i++)
+    {
+        SoundVoice *voice = &sound_voices[i];
+
+        if (voice->retired_ && SoundCommandApplied(voice->last_command_))
+            UninitSoundVoice(voice);
+    }
+}
+
+static SoundVoice *FindFreeSoundVoice(void)
+{
+    for (int i = 0; i < kMaximumSoundVoices; i++)
+    {
+        if (!sound_voices[i].in_use_)
+            return &sound_voices[i];
+    }
+
+    return nullptr;
+}
+
+SoundVoice *AllocateSoundVoice(void)
+{
+    SoundVoice *voice = FindFreeSoundVoice();
+
+    if (!voice)
+    {
+        RecycleSoundVoices();
+        voice = FindFreeSoundVoice();
+    }
+
+    if (!voice)
+    {
+        sound_queue_stats.voices_waiting++;
+        return nullptr;
+    }
+
+    voice->in_use_       = true;
+    voice->retired_      = false;
+    voice->last_command_ = sound_command_head.load(std::memory_order_relaxed);
+
+    return voice;
+}
+
+bool StartSoundChannel(int k)
+{
+    return PostVoiceCommand(kSoundCommandStart, mix_channels[k]->voice_);
+}
+
+bool LoopSoundChannel(int k)
+{
+    return PostVoiceCommand(kSoundCommandLoop, mix_channels[k]->voice_);
+}
+
+//----------------------------------------------------------------------------
+
 void InitializeSoundChannels(int total)
 {
     total_channels = total;
@@ -85,23 +307,23 @@ void InitializeSoundChannels(int total)
 
 void FreeSoundChannels(void)
 {
-    for (int i = 0; i < total_channels; i++)
-    {
-        SoundChannel *chan = mix_channels[i];
+    // let the audio thread finish with every voice before freeing them,
+    // but don't hang shutdown on a dead device.
+    uint32_t head = sound_command_head.load(std::memory_order_relaxed);
 
-        if (chan && chan->data_)
-        {
-            chan->data_       = nullptr;
-            chan->definition_ = nullptr;
-            chan->position_   = nullptr;
-            ma_sound_uninit(&chan->channel_sound_);
-            ma_audio_buffer_uninit(&chan->ref_);
-        }
+    for (int wait = 0; wait < 100 && !SoundCommandApplied(head); wait++)
+        SDL_Delay(1);
 
-        delete chan;
-    }
+    for (int i = 0; i < total_channels; i++)
+        delete mix_channels[i];
 
     EPI_CLEAR_MEMORY(mix_channels, SoundChannel *, total_channels);
+
+    for (int i = 0; i < kMaximumSoundVoices; i++)
+    {
+        if (sound_voices[i].in_use_)
+            UninitSoundVoice(&sound_voices[i]);
+    }
 }
 
 void KillSoundChannel(int k)
@@ -114,33 +336,50 @@ void KillSoundChannel(int k)
         chan->definition_ = nullptr;
         chan->position_   = nullptr;
         chan->state_      = kChannelEmpty;
-        ma_sound_stop(&chan->channel_sound_);
-        ma_sound_uninit(&chan->channel_sound_);
-        ma_audio_buffer_uninit(&chan->ref_);
+
+        // the voice is uninitialised later, in RecycleSoundVoices(),
+        // once the audio thread can no longer be touching it.
+        if (chan->voice_)
+        {
+            PostVoiceCommand(kSoundCommandStop, chan->voice_);
+            chan->voice_->retired_ = true;
+            chan->voice_           = nullptr;
+        }
     }
 }
 
 void UpdateSounds(MapObject *listener, BAMAngle angle)
 {
-    ma_sound_group_set_volume(&sfx_node, sound_effect_volume.f_ * 0.5f);
+    sound_queue_stats.last_tic_time  = sound_queue_stats.tic_time;
+    sound_queue_stats.worst_tic_time = HMM_MAX(sound_queue_stats.worst_tic_time, sound_queue_stats.tic_time);
+    sound_queue_stats.tic_time       = 0;
+
+    SoundCommand cmd;
+    EPI_CLEAR_MEMORY(&cmd, SoundCommand, 1);
+
+    cmd.type_  = kSoundCommandEffectVolume;
+    cmd.value_ = sound_effect_volume.f_ * 0.5f;
+    PostSoundCommand(cmd, nullptr);
 
     listen_x = listener ? listener->x : 0;
     listen_y = listener ? listener->y : 0;
     listen_z = listener ? listener->z : 0;
 
-    ma_engine_listener_set_position(&sound_engine, 0, listen_x, listen_z, -listen_y);
+    cmd.type_        = kSoundCommandListener;
+    cmd.position_[0] = listen_x;
+    cmd.position_[1] = listen_z;
+    cmd.position_[2] = -listen_y;
 
     if (listener)
     {
-        if (fliplevels.d_)
-            ma_engine_listener_set_direction(&sound_engine, 0, epi::BAMCos(angle - kBAMAngle180), epi::BAMTan(listener->vertical_angle_),
-                                            -epi::BAMSin(angle));
-        else
-            ma_engine_listener_set_direction(&sound_engine, 0, epi::BAMCos(angle), epi::BAMTan(listener->vertical_angle_),
-                                            -epi::BAMSin(angle));
+        BAMAngle facing = fliplevels.d_ ? angle - kBAMAngle180 : angle;
+
+        cmd.direction_[0] = epi::BAMCos(facing);
+        cmd.direction_[1] = epi::BAMTan(listener->vertical_angle_);
+        cmd.direction_[2] = -epi::BAMSin(angle);
     }
-    else
-        ma_engine_listener_set_direction(&sound_engine, 0, 0, 0, 0);
+
+    PostSoundCommand(cmd, nullptr);
 
     for (int i = 0; i < total_channels; i++)
     {
@@ -148,26 +387,65 @@ void UpdateSounds(MapObject *listener, BAMAngle angle)
 
         if (chan->state_ == kChannelPlaying)
         {
-            if (ma_sound_at_end(&chan->channel_sound_))
+            ma_sound *sound = &chan->voice_->sound_;
+            bool      at_end;
+
+            {
+                SoundAudioCallTimer timer;
+
+                at_end = ma_sound_at_end(sound);
+            }
+
+            if (at_end)
                 chan->state_ = kChannelFinished;
             else if (chan->position_)
             {
-                ma_sound_set_position(&chan->channel_sound_, chan->position_->x, chan->position_->z,
-                                      -chan->position_->y);
-                if (listener &&
-                    ma_sound_get_attenuation_model(&chan->channel_sound_) == ma_attenuation_model_exponential)
+                cmd.type_        = kSoundCommandPosition;
+                cmd.sound_       = sound;
+                cmd.position_[0] = chan->position_->x;
+                cmd.position_[1] = chan->position_->z;
+                cmd.position_[2] = -chan->position_->y;
+                cmd.value_       = 0;
+
+                if (listener && ma_sound_get_attenuation_model(sound) == ma_attenuation_model_exponential)
                 {
-                    if (CheckSightToPoint(listener, chan->position_->x, chan->position_->y, chan->position_->z))
-                        ma_sound_set_min_distance(&chan->channel_sound_, kMinimumSoundClipDistance);
+                    // no line of sight is possible out of a sealed sector
+                    if (!SoundSourceOccluded(chan->position_) &&
+                        CheckSightToPoint(listener, chan->position_->x, chan->position_->y, chan->position_->z))
+                        cmd.value_ = kMinimumSoundClipDistance;
                     else
-                        ma_sound_set_min_distance(&chan->channel_sound_, kMinimumOccludedSoundClipDistance);
+                        cmd.value_ = kMinimumOccludedSoundClipDistance;
                 }
+
+                PostSoundCommand(cmd, chan->voice_);
             }
         }
 
         if (chan->state_ == kChannelFinished)
             KillSoundChannel(i);
     }
+
+    RecycleSoundVoices();
+}
+
+void SoundQueuePrintStats(void)
+{
+    const SoundQueueStats &st = sound_queue_stats;
+
+    uint32_t depth = sound_command_head.load(std::memory_order_relaxed) -
+                     sound_command_tail.load(std::memory_order_acquire);
+
+    int voices = 0;
+    for (int i = 0; i < kMaximumSoundVoices; i++)
+        if (sound_voices[i].in_use_)
+            voices++;
+
+    LogPrint("Sound command queue: depth %u (max %u of %u), %u posted, %u dropped\n", depth, st.max_depth,
+             kSoundCommandQueueSize, st.posted, st.dropped);
+    LogPrint("  voices in use: %d / %d (%d allocations found none free)\n", voices, kMaximumSoundVoices,
+             st.voices_waiting);
+    LogPrint("  game thread in audio calls: last tic %.3f ms, worst tic %.3f ms, worst call %.3f ms\n",
+             st.last_tic_time / 1e6, st.worst_tic_time / 1e6, st.worst_call_time / 1e6);
 }
 
 void PauseSound(void)
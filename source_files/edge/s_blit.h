@@ -42,6 +42,19 @@ enum ChannelState
     kChannelFinished = 2
 };
 
+// What miniaudio actually plays for a channel.  A voice outlives its
+// channel until the audio thread has applied every command that refers
+// to it, so voices live in a pool instead of inside SoundChannel.
+struct SoundVoice
+{
+    ma_audio_buffer buffer_;
+    ma_sound        sound_;
+
+    bool     in_use_;
+    bool     retired_;
+    uint32_t last_command_; // queue position that must be reached before reuse
+};
+
 // channel info
 class SoundChannel
 {
@@ -56,9 +69,7 @@ class SoundChannel
 
     bool boss_;
 
-    ma_audio_buffer_config ref_config_;
-    ma_audio_buffer        ref_;
-    ma_sound               channel_sound_;
+    SoundVoice *voice_;
 
   public:
     SoundChannel();
@@ -66,6 +77,7 @@ class SoundChannel
 };
 
 constexpr uint16_t kMaximumSoundChannels = 128;
+constexpr uint16_t kMaximumSoundVoices   = kMaximumSoundChannels * 2;
 
 extern ConsoleVariable sound_effect_volume;
 
@@ -83,5 +95,35 @@ void KillSoundChannel(int k);
 
 void UpdateSounds(MapObject *listener, BAMAngle angle);
 
+// Returns an unused voice (not yet initialised), or nullptr if every
+// voice is still waiting on the audio thread.
+SoundVoice *AllocateSoundVoice(void);
+
+// The game thread never starts, stops or moves a playing sound itself.
+// These post a command to a single producer/single consumer queue which
+// the audio thread applies between mixing buffers.  They return false if
+// the queue was full and the command was dropped.
+bool StartSoundChannel(int k);
+bool LoopSoundChannel(int k);
+
+// ma_engine onProcess callback: applies the queued commands.  Runs on
+// the audio thread after each buffer has been mixed.
+void ProcessSoundCommands(void *user_data, float *frames_out, ma_uint64 frame_count);
+
+// Measures the time the game thread spends inside miniaudio over the
+// lifetime of the object, for "soundstats".  Scope it tightly around the
+// ma_* calls themselves (voice init/uninit, ma_sound_at_end).
+class SoundAudioCallTimer
+{
+  private:
+    uint64_t start_;
+
+  public:
+    SoundAudioCallTimer();
+    ~SoundAudioCallTimer();
+};
+
+void SoundQueuePrintStats(void);
+
 //--- editor settings ---
 // vi:ts=4:sw=4:noexpandtab
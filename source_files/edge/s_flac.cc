@@ -28,6 +28,7 @@
 #include "s_blit.h"
 #include "s_cache.h"
 #include "s_music.h"
+#include "s_stream.h"
 #include "snd_gather.h"
 #include "w_wad.h"
 
@@ -85,10 +86,11 @@ bool FLACPlayer::OpenMemory(uint8_t *data, int length)
         return false;
     }
 
-    if (ma_sound_init_from_data_source(&sound_engine, &flac_decoder,
+    if (ma_sound_init_from_data_source(&sound_engine, MusicStreamStart(&flac_decoder),
                                        MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_NO_SPATIALIZATION,
                                        NULL, &flac_stream) != MA_SUCCESS)
     {
+        MusicStreamStop();
         ma_decoder_uninit(&flac_decoder);
         LogWarning("Failed to load OGG music (corrupt ogg?)\n");
         return false;
@@ -114,6 +116,8 @@ void FLACPlayer::Close()
 
     ma_sound_uninit(&flac_stream);
 
+    MusicStreamStop();
+
     ma_decoder_uninit(&flac_decoder);
 
     delete[] flac_data_;
@@ -27,6 +27,7 @@
 #include "s_blit.h"
 #include "s_cache.h"
 #include "s_music.h"
+#include "s_stream.h"
 #include "snd_gather.h"
 #include "w_wad.h"
 
@@ -486,11 +487,12 @@ bool M4PPlayer::OpenMemory(const uint8_t *data, int length, bool loop)
         return false;
     }
 
-    if (ma_sound_init_from_data_source(&sound_engine, &m4p_decoder,
+    if (ma_sound_init_from_data_source(&sound_engine, MusicStreamStart(&m4p_decoder),
                                        MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_UNKNOWN_LENGTH | MA_SOUND_FLAG_STREAM |
                                            MA_SOUND_FLAG_NO_SPATIALIZATION,
                                        NULL, &m4p_stream) != MA_SUCCESS)
     {
+        MusicStreamStop();
         ma_decoder_uninit(&m4p_decoder);
         LogWarning("Failed to load tracker music\n");
         return false;
@@ -514,6 +516,8 @@ void M4PPlayer::Close()
 
     ma_sound_uninit(&m4p_stream);
 
+    MusicStreamStop();
+
     ma_decoder_uninit(&m4p_decoder);
 
     status_ = kNotLoaded;
@@ -37,6 +37,7 @@
 #include "s_midi.h"
 #include "s_midi_seq.h"
 #include "s_music.h"
+#include "s_stream.h"
 #include "w_files.h"
 
 extern int sound_device_frequency;
@@ -877,11 +878,12 @@ class MIDIPlayer : public AbstractMusicPlayer
             return false;
         }
 
-        if (ma_sound_init_from_data_source(&sound_engine, &midi_decoder,
+        if (ma_sound_init_from_data_source(&sound_engine, MusicStreamStart(&midi_decoder),
                                            MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_STREAM |
                                                MA_SOUND_FLAG_UNKNOWN_LENGTH | MA_SOUND_FLAG_NO_SPATIALIZATION,
                                            NULL, &midi_stream) != MA_SUCCESS)
         {
+            MusicStreamStop();
             ma_decoder_uninit(&midi_decoder);
             LogWarning("Failed to load MIDI music\n");
             return false;
@@ -905,6 +907,8 @@ class MIDIPlayer : public AbstractMusicPlayer
 
         ma_sound_uninit(&midi_stream);
 
+        MusicStreamStop();
+
         ma_decoder_uninit(&midi_decoder);
 
         if (opl_playback)
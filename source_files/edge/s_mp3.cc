@@ -28,6 +28,7 @@
 #include "s_blit.h"
 #include "s_cache.h"
 #include "s_music.h"
+#include "s_stream.h"
 #include "snd_gather.h"
 #include "w_wad.h"
 
@@ -83,10 +84,11 @@ bool MP3Player::OpenMemory(const uint8_t *data, int length)
         return false;
     }
 
-    if (ma_sound_init_from_data_source(&sound_engine, &mp3_decoder,
+    if (ma_sound_init_from_data_source(&sound_engine, MusicStreamStart(&mp3_decoder),
                                        MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_NO_SPATIALIZATION,
                                        NULL, &mp3_stream) != MA_SUCCESS)
     {
+        MusicStreamStop();
         ma_decoder_uninit(&mp3_decoder);
         LogWarning("Failed to load OGG music (corrupt ogg?)\n");
         return false;
@@ -112,6 +114,8 @@ void MP3Player::Close()
 
     ma_sound_uninit(&mp3_stream);
 
+    MusicStreamStop();
+
     ma_decoder_uninit(&mp3_decoder);
 
     delete[] mp3_data_;
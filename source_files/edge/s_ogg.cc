@@ -31,6 +31,7 @@
 #include "s_blit.h"
 #include "s_cache.h"
 #include "s_music.h"
+#include "s_stream.h"
 #include "snd_gather.h"
 
 static ma_decoder ogg_decoder;
@@ -590,10 +591,11 @@ bool OGGPlayer::OpenMemory(const uint8_t *data, int length)
         return false;
     }
 
-    if (ma_sound_init_from_data_source(&sound_engine, &ogg_decoder,
+    if (ma_sound_init_from_data_source(&sound_engine, MusicStreamStart(&ogg_decoder),
                                        MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_STREAM | MA_SOUND_FLAG_NO_SPATIALIZATION,
                                        NULL, &ogg_stream) != MA_SUCCESS)
     {
+        MusicStreamStop();
         ma_decoder_uninit(&ogg_decoder);
         LogWarning("Failed to load OGG music (corrupt ogg?)\n");
         return false;
@@ -619,6 +621,8 @@ void OGGPlayer::Close()
 
     ma_sound_uninit(&ogg_stream);
 
+    MusicStreamStop();
+
     ma_decoder_uninit(&ogg_decoder);
 
     delete[] ogg_data_;
@@ -27,6 +27,7 @@
 #include "s_blit.h"
 #include "s_cache.h"
 #include "s_music.h"
+#include "s_stream.h"
 #include "snd_gather.h"
 #include "w_wad.h"
 
@@ -482,11 +483,12 @@ bool SIDPlayer::OpenMemory(const uint8_t *data, int length)
         return false;
     }
 
-    if (ma_sound_init_from_data_source(&sound_engine, &sid_decoder,
+    if (ma_sound_init_from_data_source(&sound_engine, MusicStreamStart(&sid_decoder),
                                        MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_UNKNOWN_LENGTH | MA_SOUND_FLAG_STREAM |
                                            MA_SOUND_FLAG_NO_SPATIALIZATION,
                                        NULL, &sid_stream) != MA_SUCCESS)
     {
+        MusicStreamStop();
         ma_decoder_uninit(&sid_decoder);
         LogWarning("Failed to load tracker music\n");
         return false;
@@ -510,6 +512,8 @@ void SIDPlayer::Close()
 
     ma_sound_uninit(&sid_stream);
 
+    MusicStreamStop();
+
     ma_decoder_uninit(&sid_decoder);
 
     status_ = kNotLoaded;
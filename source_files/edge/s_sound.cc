@@ -28,8 +28,10 @@
 #include "i_system.h"
 #include "m_argv.h"
 #include "m_misc.h"
+#include "m_profile.h"
 #include "m_random.h"
 #include "p_local.h" // ApproximateDistance
+#include "r_misc.h"  // PointInSubsector
 #include "s_blit.h"
 #include "s_cache.h"
 #include "s_music.h"
@@ -46,6 +48,38 @@ extern float listen_z;
 
 static constexpr float kMaximumSoundClipDistance = 4000.0f;
 
+// drop sounds from sectors sealed off from the listener once they are
+// beyond the distance they could still be heard at.  Off by default, as
+// those sounds are faint rather than silent.
+EDGE_DEFINE_CONSOLE_VARIABLE(sound_occlusion, "0", kConsoleVariableFlagArchive)
+
+// requests started since the last SoundTicker(), so identical
+// sound/origin pairs within one tic only play once.  Entries for an
+// origin are forgotten by StopSoundEffect(), which is always called
+// before a map object is freed, so a new object reusing the address
+// never has its sound merged away.
+struct RecentSoundRequest
+{
+    const SoundEffect *sfx;
+    const Position    *pos;
+};
+
+static constexpr int kMaximumRecentSoundRequests = 64;
+
+static RecentSoundRequest recent_requests[kMaximumRecentSoundRequests];
+static int                total_recent_requests = 0;
+
+struct SoundRequestStats
+{
+    int distance_culled;
+    int occlusion_culled;
+    int merged;
+    int dropped;
+    int played;
+};
+
+static SoundRequestStats sound_request_stats;
+
 static constexpr uint8_t category_limit_table[kTotalCategories] = {
 
     /* 32 channel */
@@ -324,13 +358,19 @@ SoundEffectDefinition *LookupEffectDef(const SoundEffect *s)
     return sfxdefs[num];
 }
 
-static void S_PlaySound(int idx, const SoundEffectDefinition *def, int category, const Position *pos, int flags,
+// returns false if no voice was free
+static bool S_PlaySound(int idx, const SoundEffectDefinition *def, int category, const Position *pos, int flags,
                         SoundData *buf)
 {
+    SoundVoice *voice = AllocateSoundVoice();
+    if (!voice)
+        return false;
+
     SoundChannel *chan = mix_channels[idx];
 
     chan->state_ = kChannelPlaying;
     chan->data_  = buf;
+    chan->voice_ = voice;
 
     chan->definition_ = def;
     chan->position_   = pos;
@@ -341,64 +381,83 @@ static void S_PlaySound(int idx, const SoundEffectDefinition *def, int category,
     bool attenuate =
         (!chan->boss_ && pos && category != kCategoryWeapon && category != kCategoryPlayer && category != kCategoryUi);
 
-    chan->ref_config_            = ma_audio_buffer_config_init(ma_format_f32, 2, buf->length_, buf->data_, NULL);
-    chan->ref_config_.sampleRate = buf->frequency_;
-    ma_audio_buffer_init(&chan->ref_config_, &chan->ref_);
-    chan->ref_.ref.ds.vtable = &SFXVTable;
-    ma_sound_init_from_data_source(&sound_engine, &chan->ref_,
-                                   attenuate ? MA_SOUND_FLAG_NO_PITCH
-                                             : (MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_NO_SPATIALIZATION),
-                                   NULL, &chan->channel_sound_);
+    // the sound stays stopped (and so is skipped by the mixer) until the
+    // audio thread applies the start command, which makes it safe to set
+    // up from here.  It is attached once, straight to its output node.
+    ma_sound *sound = &voice->sound_;
+
+    {
+        SoundAudioCallTimer timer;
+
+        ma_audio_buffer_config ref_config =
+            ma_audio_buffer_config_init(ma_format_f32, 2, buf->length_, buf->data_, NULL);
+        ref_config.sampleRate = buf->frequency_;
+        ma_audio_buffer_init(&ref_config, &voice->buffer_);
+        voice->buffer_.ref.ds.vtable = &SFXVTable;
+
+        ma_sound_init_from_data_source(&sound_engine, &voice->buffer_,
+                                       MA_SOUND_FLAG_NO_DEFAULT_ATTACHMENT |
+                                           (attenuate ? MA_SOUND_FLAG_NO_PITCH
+                                                      : (MA_SOUND_FLAG_NO_PITCH | MA_SOUND_FLAG_NO_SPATIALIZATION)),
+                                       NULL, sound);
+    }
     if (attenuate)
     {
-        ma_sound_set_attenuation_model(&chan->channel_sound_, ma_attenuation_model_exponential);
+        ma_sound_set_attenuation_model(sound, ma_attenuation_model_exponential);
         
         // Lobo 2026: possible to get here before we actually have a player mobj so make sure
         if (players[display_player]->map_object_ && CheckSightToPoint(players[display_player]->map_object_, pos->x, pos->y, pos->z))
-            ma_sound_set_min_distance(&chan->channel_sound_, kMinimumSoundClipDistance);
+            ma_sound_set_min_distance(sound, kMinimumSoundClipDistance);
         else
-            ma_sound_set_min_distance(&chan->channel_sound_, kMinimumOccludedSoundClipDistance);
-        ma_sound_set_max_distance(&chan->channel_sound_, kMaximumSoundClipDistance);
-        ma_sound_set_position(&chan->channel_sound_, pos->x, pos->z, -pos->y);
+            ma_sound_set_min_distance(sound, kMinimumOccludedSoundClipDistance);
+        ma_sound_set_max_distance(sound, kMaximumSoundClipDistance);
+        ma_sound_set_position(sound, pos->x, pos->z, -pos->y);
         if (pc_speaker_mode)
-            ma_node_attach_output_bus(&chan->channel_sound_, 0, &sfx_node, 0);
+            ma_node_attach_output_bus(sound, 0, &sfx_node, 0);
         else if (vacuum_sound_effects)
-            ma_node_attach_output_bus(&chan->channel_sound_, 0, &vacuum_node, 0);
+            ma_node_attach_output_bus(sound, 0, &vacuum_node, 0);
         else if (submerged_sound_effects)
-            ma_node_attach_output_bus(&chan->channel_sound_, 0, &underwater_node, 0);
+            ma_node_attach_output_bus(sound, 0, &underwater_node, 0);
         else if (sector_reverb || dynamic_reverb.d_)
-            ma_node_attach_output_bus(&chan->channel_sound_, 0, &reverb_node, 0);
+            ma_node_attach_output_bus(sound, 0, &reverb_node, 0);
         else
-            ma_node_attach_output_bus(&chan->channel_sound_, 0, &sfx_node, 0);
+            ma_node_attach_output_bus(sound, 0, &sfx_node, 0);
     }
     else
     {
-        ma_sound_set_attenuation_model(&chan->channel_sound_, ma_attenuation_model_none);
+        ma_sound_set_attenuation_model(sound, ma_attenuation_model_none);
         if (pc_speaker_mode)
-            ma_node_attach_output_bus(&chan->channel_sound_, 0, &sfx_node, 0);
+            ma_node_attach_output_bus(sound, 0, &sfx_node, 0);
         else if (category != kCategoryUi)
         {
             if (vacuum_sound_effects)
-                ma_node_attach_output_bus(&chan->channel_sound_, 0, &vacuum_node, 0);
+                ma_node_attach_output_bus(sound, 0, &vacuum_node, 0);
             else if (submerged_sound_effects)
-                ma_node_attach_output_bus(&chan->channel_sound_, 0, &underwater_node, 0);
+                ma_node_attach_output_bus(sound, 0, &underwater_node, 0);
             else if (sector_reverb || dynamic_reverb.d_)
-                ma_node_attach_output_bus(&chan->channel_sound_, 0, &reverb_node, 0);
+                ma_node_attach_output_bus(sound, 0, &reverb_node, 0);
             else
-                ma_node_attach_output_bus(&chan->channel_sound_, 0, &sfx_node, 0);
+                ma_node_attach_output_bus(sound, 0, &sfx_node, 0);
         }
         else
-            ma_node_attach_output_bus(&chan->channel_sound_, 0, &sfx_node, 0);
+            ma_node_attach_output_bus(sound, 0, &sfx_node, 0);
     }
     if (chan->boss_)
-        ma_sound_set_volume(&chan->channel_sound_, 1.0f);
+        ma_sound_set_volume(sound, 1.0f);
     else
-        ma_sound_set_volume(&chan->channel_sound_, def->volume_);
-    ma_sound_set_looping(&chan->channel_sound_, def->looping_ ? MA_TRUE : MA_FALSE);
-    ma_sound_start(&chan->channel_sound_);
+        ma_sound_set_volume(sound, def->volume_);
+    ma_sound_set_looping(sound, def->looping_ ? MA_TRUE : MA_FALSE);
+
+    // if the queue is full the sound can never start, so let the next
+    // UpdateSounds() reclaim the channel.
+    if (!StartSoundChannel(idx))
+        chan->state_ = kChannelFinished;
+
+    return true;
 }
 
-static void DoStartFX(const SoundEffectDefinition *def, int category, const Position *pos, int flags, SoundData *buf)
+// returns false if the sound was dropped
+static bool DoStartFX(const SoundEffectDefinition *def, int category, const Position *pos, int flags, SoundData *buf)
 {
     CountPlayingCats();
 
@@ -410,17 +469,16 @@ static void DoStartFX(const SoundEffectDefinition *def, int category, const Posi
 
         if (def->looping_ && def == chan->definition_)
         {
-            ma_sound_set_looping(&chan->channel_sound_, MA_TRUE);
-            return;
+            LoopSoundChannel(k);
+            return true;
         }
         else if (flags & kSoundEffectSingle)
         {
             if (chan->definition_->precious_)
-                return;
+                return false;
 
             KillSoundChannel(k);
-            S_PlaySound(k, def, category, pos, flags, buf);
-            return;
+            return S_PlaySound(k, def, category, pos, flags, buf);
         }
     }
 
@@ -453,12 +511,46 @@ static void DoStartFX(const SoundEffectDefinition *def, int category, const Posi
         k = FindChannelToKill(kill_cat, category, new_score);
 
         if (k < 0)
-            return;
+            return false;
 
         KillSoundChannel(k);
     }
 
-    S_PlaySound(k, def, category, pos, flags, buf);
+    return S_PlaySound(k, def, category, pos, flags, buf);
+}
+
+// returns true if the same sound was already started here this tic
+static bool MergeSoundRequest(const SoundEffect *sfx, const Position *pos)
+{
+    for (int i = 0; i < total_recent_requests; i++)
+    {
+        if (recent_requests[i].sfx == sfx && recent_requests[i].pos == pos)
+            return true;
+    }
+
+    if (total_recent_requests < kMaximumRecentSoundRequests)
+    {
+        recent_requests[total_recent_requests].sfx = sfx;
+        recent_requests[total_recent_requests].pos = pos;
+        total_recent_requests++;
+    }
+
+    return false;
+}
+
+bool SoundSourceOccluded(const Position *pos)
+{
+    if (!pos || game_state != kGameStateLevel)
+        return false;
+
+    const Player *p = players[display_player];
+
+    if (!p || !p->map_object_ || !p->map_object_->subsector_)
+        return false;
+
+    Sector *source = PointInSubsector(pos->x, pos->y)->sector;
+
+    return !SoundSectorAudible(p->map_object_->subsector_->sector, source);
 }
 
 void StartSoundEffect(const SoundEffect *sfx, int category, const Position *pos, int flags)
@@ -474,6 +566,12 @@ void StartSoundEffect(const SoundEffect *sfx, int category, const Position *pos,
     if (category >= kCategoryOpponent && !pos)
         FatalError("StartSoundEffect: position missing for category: %d\n", category);
 
+    if (MergeSoundRequest(sfx, pos))
+    {
+        sound_request_stats.merged++;
+        return;
+    }
+
     SoundEffectDefinition *def = LookupEffectDef(sfx);
     EPI_ASSERT(def);
 
@@ -483,7 +581,20 @@ void StartSoundEffect(const SoundEffect *sfx, int category, const Position *pos,
         float dist = ApproximateDistance(listen_x - pos->x, listen_y - pos->y, listen_z - pos->z);
 
         if (dist > def->max_distance_)
+        {
+            sound_request_stats.distance_culled++;
             return;
+        }
+
+        // occluded sounds get half the minimum distance in S_PlaySound,
+        // i.e. they are as loud as an open sound twice as far away.
+        if (sound_occlusion.d_ &&
+            dist > def->max_distance_ * (kMinimumOccludedSoundClipDistance / kMinimumSoundClipDistance) &&
+            SoundSourceOccluded(pos))
+        {
+            sound_request_stats.occlusion_culled++;
+            return;
+        }
     }
 
     if (def->singularity_ > 0)
@@ -499,11 +610,20 @@ void StartSoundEffect(const SoundEffect *sfx, int category, const Position *pos,
     if (!buf)
         return;
 
-    DoStartFX(def, category, pos, flags, buf);
+    if (DoStartFX(def, category, pos, flags, buf))
+        sound_request_stats.played++;
+    else
+        sound_request_stats.dropped++;
 }
 
 void StopSoundEffect(const Position *pos)
 {
+    for (int i = total_recent_requests - 1; i >= 0; i--)
+    {
+        if (recent_requests[i].pos == pos)
+            recent_requests[i] = recent_requests[--total_recent_requests];
+    }
+
     if (no_sound)
         return;
 
@@ -556,6 +676,10 @@ void StopAllSoundEffects(void)
 
 void SoundTicker(void)
 {
+    EDGE_PROFILE_SCOPE("SoundTicker");
+
+    total_recent_requests = 0;
+
     if (no_sound || playing_movie)
         return;
 
@@ -574,6 +698,24 @@ void SoundTicker(void)
     }
 }
 
+void SoundPrintStats(void)
+{
+    const SoundRequestStats &st = sound_request_stats;
+
+    LogPrint("Sound requests: %d played, %d dropped (no channel)\n", st.played, st.dropped);
+    LogPrint("  culled: %d by distance, %d occluded\n", st.distance_culled, st.occlusion_culled);
+    LogPrint("  merged: %d (same sound and origin in one tic)\n", st.merged);
+
+    int playing = 0;
+    for (int i = 0; i < total_channels; i++)
+        if (mix_channels[i]->state_ == kChannelPlaying)
+            playing++;
+
+    LogPrint("  channels playing: %d / %d\n", playing, total_channels);
+
+    SoundQueuePrintStats();
+}
+
 void PrecacheSounds(void)
 {
     StartupProgressMessage("Precaching SFX...");
@@ -92,6 +92,12 @@ void PauseSound(void);
 
 void SoundTicker(void);
 
+// true when the position is in a sector sealed off from the listener
+// (closed doors/solid walls only).
+bool SoundSourceOccluded(const Position *pos);
+
+void SoundPrintStats(void);
+
 void PrecacheSounds(void);
 
 //--- editor settings ---
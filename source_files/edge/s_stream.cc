@@ -0,0 +1,323 @@
+//----------------------------------------------------------------------------
+//  EDGE Music Streaming
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+//
+// Music decoders (especially the software MIDI synths) used to run inside
+// the audio thread's mixing callback, competing with the sound effects.
+// Here a decode thread keeps a ring buffer topped up instead, and the
+// audio thread only copies out of it.
+//
+// The ring buffer is miniaudio's single producer, single consumer one, so
+// neither side ever takes a lock.  The decode thread is the only user of
+// the decoder once streaming has started.
+//
+
+#include "s_stream.h"
+
+#include <atomic>
+
+#include "HandmadeMath.h"
+#include "epi.h"
+#include "epi_sdl.h"
+#include "epi_thread.h"
+#include "i_system.h"
+
+// milliseconds of music decoded ahead of playback; 0 decodes on the
+// audio thread as before.
+EDGE_DEFINE_CONSOLE_VARIABLE_CLAMPED(music_lookahead, "250", kConsoleVariableFlagArchive, 0, 2000)
+
+// how often the decode thread checks for space when it hears nothing
+static constexpr int kStreamIdleMilliseconds = 20;
+
+enum StreamSeekState
+{
+    kStreamSeekNone = 0,
+    kStreamSeekRequested, // consumer wants a seek, producer stops writing
+    kStreamSeekFlush,     // producer has seeked, consumer drops old frames
+};
+
+struct MusicStream
+{
+    // must be first, this is what miniaudio sees
+    ma_data_source_base ds;
+
+    ma_data_source *decoder;
+    ma_pcm_rb       ring;
+
+    ma_format format;
+    ma_uint32 channels;
+    ma_uint32 sample_rate;
+    ma_uint32 frame_bytes;
+    ma_uint32 chunk_frames;
+
+    SDL_Thread *thread;
+    SDL_sem    *wake;
+
+    std::atomic<bool>      quit;
+    std::atomic<bool>      finished; // decoder hit the end (not looping)
+    std::atomic<int>       seek_state;
+    std::atomic<ma_uint64> seek_frame;
+
+    // only touched by the consumer
+    ma_uint64 cursor;
+    int       underruns;
+};
+
+static MusicStream music_stream;
+static bool        music_stream_active = false;
+
+static ma_result StreamRead(ma_data_source *source, void *frames_out, ma_uint64 frame_count, ma_uint64 *frames_read)
+{
+    MusicStream *ms  = (MusicStream *)source;
+    uint8_t     *out = (uint8_t *)frames_out;
+
+    int seek_state = ms->seek_state.load(std::memory_order_acquire);
+
+    if (seek_state == kStreamSeekFlush)
+    {
+        ma_uint32 stale = ma_pcm_rb_available_read(&ms->ring);
+        ma_pcm_rb_seek_read(&ms->ring, stale);
+
+        ms->seek_state.store(kStreamSeekNone, std::memory_order_release);
+        seek_state = kStreamSeekNone;
+    }
+
+    ma_uint64 total = 0;
+
+    if (seek_state == kStreamSeekNone)
+    {
+        while (total < frame_count)
+        {
+            ma_uint32 count = (ma_uint32)HMM_MIN(frame_count - total, (ma_uint64)0xFFFFFFFF);
+            void     *buffer;
+
+            if (ma_pcm_rb_acquire_read(&ms->ring, &count, &buffer) != MA_SUCCESS || count == 0)
+                break;
+
+            memcpy(out + total * ms->frame_bytes, buffer, count * ms->frame_bytes);
+            ma_pcm_rb_commit_read(&ms->ring, count);
+
+            total += count;
+        }
+    }
+
+    if (total > 0 || seek_state != kStreamSeekNone)
+        SDL_SemPost(ms->wake);
+
+    if (total < frame_count)
+    {
+        // the end is only real once everything decoded has been played
+        if (seek_state == kStreamSeekNone && ms->finished.load(std::memory_order_acquire) &&
+            ma_pcm_rb_available_read(&ms->ring) == 0)
+        {
+            ms->cursor += total;
+            *frames_read = total;
+            return total > 0 ? MA_SUCCESS : MA_AT_END;
+        }
+
+        // decoder fell behind: pad with silence rather than stopping
+        ma_silence_pcm_frames(out + total * ms->frame_bytes, frame_count - total, ms->format, ms->channels);
+        ms->underruns++;
+    }
+
+    ms->cursor += total;
+    *frames_read = frame_count;
+    return MA_SUCCESS;
+}
+
+static ma_result StreamSeek(ma_data_source *source, ma_uint64 frame_index)
+{
+    MusicStream *ms = (MusicStream *)source;
+
+    ms->seek_frame.store(frame_index, std::memory_order_relaxed);
+    ms->seek_state.store(kStreamSeekRequested, std::memory_order_release);
+    ms->cursor = frame_index;
+
+    SDL_SemPost(ms->wake);
+    return MA_SUCCESS;
+}
+
+static ma_result StreamGetDataFormat(ma_data_source *source, ma_format *format, ma_uint32 *channels,
+                                     ma_uint32 *sample_rate, ma_channel *channel_map, size_t channel_map_cap)
+{
+    MusicStream *ms = (MusicStream *)source;
+
+    if (format)
+        *format = ms->format;
+    if (channels)
+        *channels = ms->channels;
+    if (sample_rate)
+        *sample_rate = ms->sample_rate;
+    if (channel_map)
+        ma_channel_map_init_standard(ma_standard_channel_map_default, channel_map, channel_map_cap, ms->channels);
+
+    return MA_SUCCESS;
+}
+
+static ma_result StreamGetCursor(ma_data_source *source, ma_uint64 *cursor)
+{
+    *cursor = ((MusicStream *)source)->cursor;
+    return MA_SUCCESS;
+}
+
+static ma_result StreamGetLength(ma_data_source *source, ma_uint64 *length)
+{
+    EPI_UNUSED(source);
+    *length = 0;
+    return MA_NOT_IMPLEMENTED;
+}
+
+static ma_data_source_vtable stream_vtable = {StreamRead,      StreamSeek, StreamGetDataFormat, StreamGetCursor,
+                                              StreamGetLength, NULL, /* onSetLooping */
+                                              0};
+
+static int StreamThreadProc(void *data)
+{
+    MusicStream *ms = (MusicStream *)data;
+
+    while (!ms->quit.load(std::memory_order_acquire))
+    {
+        int seek_state = ms->seek_state.load(std::memory_order_acquire);
+
+        if (seek_state == kStreamSeekRequested)
+        {
+            ma_data_source_seek_to_pcm_frame(ms->decoder, ms->seek_frame.load(std::memory_order_relaxed));
+            ms->finished.store(false, std::memory_order_release);
+            ms->seek_state.store(kStreamSeekFlush, std::memory_order_release);
+            continue;
+        }
+
+        // nothing may be written until the consumer has dropped the
+        // frames from before the seek
+        if (seek_state == kStreamSeekFlush || ms->finished.load(std::memory_order_acquire) ||
+            ma_pcm_rb_available_write(&ms->ring) < ms->chunk_frames)
+        {
+            SDL_SemWaitTimeout(ms->wake, kStreamIdleMilliseconds);
+            continue;
+        }
+
+        ma_uint32 count = ms->chunk_frames;
+        void     *buffer;
+
+        if (ma_pcm_rb_acquire_write(&ms->ring, &count, &buffer) != MA_SUCCESS)
+            continue;
+
+        ma_uint64 decoded = 0;
+        ma_result result  = ma_data_source_read_pcm_frames(ms->decoder, buffer, count, &decoded);
+
+        ma_pcm_rb_commit_write(&ms->ring, (ma_uint32)decoded);
+
+        if (result != MA_SUCCESS || decoded < count)
+        {
+            // looping is set on the music ma_sound, i.e. on this stream
+            if (ma_data_source_is_looping(&ms->ds) &&
+                ma_data_source_seek_to_pcm_frame(ms->decoder, 0) == MA_SUCCESS)
+                continue;
+
+            ms->finished.store(true, std::memory_order_release);
+        }
+    }
+
+    return 0;
+}
+
+ma_data_source *MusicStreamStart(ma_data_source *decoder)
+{
+#ifdef EPI_THREADS
+    EPI_ASSERT(!music_stream_active);
+
+    if (music_lookahead.d_ <= 0)
+        return decoder;
+
+    MusicStream *ms = &music_stream;
+
+    ms->decoder = decoder;
+
+    if (ma_data_source_get_data_format(decoder, &ms->format, &ms->channels, &ms->sample_rate, NULL, 0) != MA_SUCCESS)
+        return decoder;
+
+    ms->frame_bytes = ma_get_bytes_per_frame(ms->format, ms->channels);
+
+    ma_uint32 capacity = HMM_MAX(2048u, ms->sample_rate * (ma_uint32)music_lookahead.d_ / 1000);
+    ms->chunk_frames   = HMM_MIN(capacity / 4, 4096u);
+
+    if (ma_pcm_rb_init(ms->format, ms->channels, capacity, NULL, NULL, &ms->ring) != MA_SUCCESS)
+        return decoder;
+
+    ma_data_source_config config = ma_data_source_config_init();
+    config.vtable                = &stream_vtable;
+
+    if (ma_data_source_init(&config, &ms->ds) != MA_SUCCESS)
+    {
+        ma_pcm_rb_uninit(&ms->ring);
+        return decoder;
+    }
+
+    ms->quit       = false;
+    ms->finished   = false;
+    ms->seek_state = kStreamSeekNone;
+    ms->seek_frame = 0;
+    ms->cursor     = 0;
+    ms->underruns  = 0;
+
+    ms->wake   = SDL_CreateSemaphore(0);
+    ms->thread = ms->wake ? SDL_CreateThread(StreamThreadProc, "EDGE Music", ms) : nullptr;
+
+    if (!ms->thread)
+    {
+        LogWarning("MusicStreamStart: unable to create thread: %s\n", SDL_GetError());
+        if (ms->wake)
+            SDL_DestroySemaphore(ms->wake);
+        ma_data_source_uninit(&ms->ds);
+        ma_pcm_rb_uninit(&ms->ring);
+        return decoder;
+    }
+
+    music_stream_active = true;
+
+    return &ms->ds;
+#else
+    return decoder;
+#endif
+}
+
+void MusicStreamStop(void)
+{
+    if (!music_stream_active)
+        return;
+
+    MusicStream *ms = &music_stream;
+
+    ms->quit.store(true, std::memory_order_release);
+    SDL_SemPost(ms->wake);
+    SDL_WaitThread(ms->thread, nullptr);
+
+    if (ms->underruns > 0)
+        LogDebug("MusicStreamStop: %d underruns\n", ms->underruns);
+
+    SDL_DestroySemaphore(ms->wake);
+    ma_data_source_uninit(&ms->ds);
+    ma_pcm_rb_uninit(&ms->ring);
+
+    ms->thread = nullptr;
+    ms->wake   = nullptr;
+
+    music_stream_active = false;
+}
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
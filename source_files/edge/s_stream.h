@@ -0,0 +1,39 @@
+//----------------------------------------------------------------------------
+//  EDGE Music Streaming
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include "con_var.h"
+#include "miniaudio.h"
+
+extern ConsoleVariable music_lookahead;
+
+// Starts decoding the given music decoder ahead of playback on a
+// background thread, into a lock-free ring buffer of music_lookahead
+// milliseconds.  Returns the data source to give to the music ma_sound
+// in place of the decoder (the decoder itself when streaming is disabled
+// or threads are unavailable).  Looping is taken from that ma_sound.
+// Only one music stream exists at a time.
+ma_data_source *MusicStreamStart(ma_data_source *decoder);
+
+// Stops the decode thread.  Call after ma_sound_uninit() of the music
+// sound and before uninitialising the decoder.
+void MusicStreamStop(void);
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
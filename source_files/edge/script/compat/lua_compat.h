@@ -23,6 +23,7 @@ void LuaSaveGame(void);
 void LuaBeginLevel(void);
 void LuaEndLevel(void);
 void CreateLuaTable_Mobj(lua_State *L, MapObject *mo);
+void FillLuaTable_Mobj(lua_State *L, int index, MapObject *mo);
 
 // Core
 void LuaRegisterCoreLibraries(lua_State *L);
@@ -38,6 +39,19 @@ void LuaRegisterHUDLibrary(lua_State *L);
 
 lua_State *LuaGetGlobalVM();
 
+// Counters kept by the Lua allocator
+struct LuaAllocatorStats
+{
+    uint64_t allocations   = 0;
+    uint64_t reallocations = 0;
+    uint64_t frees         = 0;
+    size_t   bytes_in_use  = 0;
+    size_t   peak_bytes    = 0;
+};
+
+const LuaAllocatorStats &LuaGetAllocatorStats();
+void                     LuaPrintMemoryStats();
+
 inline HMM_Vec3 LuaCheckVector3(lua_State *L, int index)
 {
     HMM_Vec3 v;
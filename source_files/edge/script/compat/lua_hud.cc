@@ -7,6 +7,7 @@
 #include "hu_draw.h"
 #include "i_system.h"
 #include "lua_compat.h"
+#include "m_profile.h"
 #include "r_colormap.h"
 #include "r_misc.h"
 #include "rad_trig.h"
@@ -1153,6 +1154,8 @@ void LuaRegisterHUDLibrary(lua_State *L)
 
 void LuaRunHUD(void)
 {
+    EDGE_PROFILE_SCOPE("LuaRunHUD");
+
     HUDReset();
 
     ui_hud_who    = players[display_player];
@@ -1437,7 +1437,9 @@ static int MO_query_tid(lua_State *L)
 
 // CreateLuaTable_Benefits(LuaState, mobj, Killbenefits);
 //
-static void CreateLuaTable_Benefits(lua_State *L, MapObject *obj, bool KillBenefits = false)
+// Pushes the benefits table, or returns false (pushing nothing) when
+// the object has none.
+static bool CreateLuaTable_Benefits(lua_State *L, MapObject *obj, bool KillBenefits = false)
 {
     Benefit    *list;
     std::string BenefitName;
@@ -1458,9 +1460,7 @@ static void CreateLuaTable_Benefits(lua_State *L, MapObject *obj, bool KillBenef
     }
 
     if (NumberOfBenefits < 1)
-        return;
-
-    lua_pushstring(L, "benefits");
+        return false;
 
     int NumberOfBenefitFields = 4;           // how many fields in a row
     lua_createtable(L, NumberOfBenefits, 0); // create BENEFITS table
@@ -1594,126 +1594,154 @@ static void CreateLuaTable_Benefits(lua_State *L, MapObject *obj, bool KillBenef
         CurrentBenefit++;
     }
 
-    lua_settable(L, -3); // add to MOBJ Table
+    return true;
 }
 
-// CreateLuaTable_Mobj(LuaState, mobj)
-//
-void CreateLuaTable_Mobj(lua_State *L, MapObject *mo)
+enum LuaMapObjectField
+{
+    kLuaMapObjectFieldName = 1,
+    kLuaMapObjectFieldTag,
+    kLuaMapObjectFieldTid,
+    kLuaMapObjectFieldType,
+    kLuaMapObjectFieldCurrentHealth,
+    kLuaMapObjectFieldSpawnHealth,
+    kLuaMapObjectFieldX,
+    kLuaMapObjectFieldY,
+    kLuaMapObjectFieldZ,
+    kLuaMapObjectFieldAngle,
+    kLuaMapObjectFieldMlook,
+    kLuaMapObjectFieldRadius,
+    kLuaMapObjectFieldBenefits,
+    kTotalLuaMapObjectFields
+};
+
+static const char *lua_map_object_field_names[kTotalLuaMapObjectFields] = {
+    nullptr, "name", "tag", "tid", "type", "current_health", "spawn_health", "x", "y", "z", "angle", "mlook", "radius",
+    "benefits"};
+
+// Pushes a single mobj field, or returns false (pushing nothing) when the
+// field has no value for this object.
+static bool LuaPushMapObjectField(lua_State *L, MapObject *mo, int field)
 {
     std::string temp_value;
-    int         NumberOfItems = 13;       // how many fields in a row
-    lua_createtable(L, 0, NumberOfItems); // our MOBJ table
+    float       value;
 
-    //---------------
-    // object.name
-    temp_value = language[mo->info_->cast_title_]; // try CAST_TITLE first
-    if (temp_value.empty())                        // fallback to DDFTHING entry name
+    switch (field)
     {
-        temp_value = mo->info_->name_;
-        temp_value = AuxStringReplaceAll(temp_value, std::string("_"), std::string(" "));
-    }
+    case kLuaMapObjectFieldName:
+        temp_value = language[mo->info_->cast_title_]; // try CAST_TITLE first
+        if (temp_value.empty())                        // fallback to DDFTHING entry name
+        {
+            temp_value = mo->info_->name_;
+            temp_value = AuxStringReplaceAll(temp_value, std::string("_"), std::string(" "));
+        }
+        lua_pushstring(L, temp_value.c_str());
+        return true;
 
-    lua_pushstring(L, temp_value.c_str());
-    lua_setfield(L, -2, "name"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldTag:
+        lua_pushinteger(L, (int)mo->tag_);
+        return true;
 
-    //---------------
-    // object.tag
-    lua_pushinteger(L, (int)mo->tag_);
-    lua_setfield(L, -2, "tag"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldTid:
+        lua_pushinteger(L, (int)mo->tid_);
+        return true;
 
-    //---------------
-    // object.tid
-    lua_pushinteger(L, (int)mo->tid_);
-    lua_setfield(L, -2, "tid"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldType:
+        temp_value = "SCENERY"; // default to scenery
 
-    //---------------
-    // object.type
-    temp_value = "SCENERY"; // default to scenery
+        if (mo->extended_flags_ & kExtendedFlagMonster)
+            temp_value = "MONSTER";
+        if (mo->flags_ & kMapObjectFlagSpecial)
+            temp_value = "PICKUP";
+        if (mo->info_->pickup_benefits_)
+        {
+            if (mo->info_->pickup_benefits_->type == kBenefitTypeWeapon)
+                temp_value = "WEAPON";
+        }
+        lua_pushstring(L, temp_value.c_str());
+        return true;
 
-    if (mo->extended_flags_ & kExtendedFlagMonster)
-        temp_value = "MONSTER";
-    if (mo->flags_ & kMapObjectFlagSpecial)
-        temp_value = "PICKUP";
-    if (mo->info_->pickup_benefits_)
-    {
-        if (mo->info_->pickup_benefits_->type == kBenefitTypeWeapon)
-            temp_value = "WEAPON";
-    }
+    case kLuaMapObjectFieldCurrentHealth:
+        lua_pushinteger(L, (int)mo->health_);
+        return true;
 
-    lua_pushstring(L, temp_value.c_str());
-    lua_setfield(L, -2, "type"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldSpawnHealth:
+        lua_pushinteger(L, (int)mo->spawn_health_);
+        return true;
 
-    //---------------
-    // object.currenthealth
-    lua_pushinteger(L, (int)mo->health_);
-    lua_setfield(L, -2, "current_health"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldX:
+        lua_pushinteger(L, (int)mo->x);
+        return true;
 
-    //---------------
-    // object.spawnhealth
-    lua_pushinteger(L, (int)mo->spawn_health_);
-    lua_setfield(L, -2, "spawn_health"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldY:
+        lua_pushinteger(L, (int)mo->y);
+        return true;
 
-    //---------------
-    // object.x
-    lua_pushinteger(L, (int)mo->x);
-    lua_setfield(L, -2, "x"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldZ:
+        lua_pushinteger(L, (int)mo->z);
+        return true;
 
-    //---------------
-    // object.y
-    lua_pushinteger(L, (int)mo->y);
-    lua_setfield(L, -2, "y"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldAngle:
+        value = epi::DegreesFromBAM(mo->angle_);
+        if (value > 360.0f)
+            value -= 360.0f;
+        if (value < 0)
+            value += 360.0f;
+        lua_pushinteger(L, (int)value);
+        return true;
 
-    //---------------
-    // object.z
-    lua_pushinteger(L, (int)mo->z);
-    lua_setfield(L, -2, "z"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldMlook:
+        value = epi::DegreesFromBAM(mo->vertical_angle_);
+        if (value > 180.0f)
+            value -= 360.0f;
+        lua_pushinteger(L, (int)value);
+        return true;
 
-    //---------------
-    // object.angle
-    float value = epi::DegreesFromBAM(mo->angle_);
-    if (value > 360.0f)
-        value -= 360.0f;
-    if (value < 0)
-        value += 360.0f;
+    case kLuaMapObjectFieldRadius:
+        lua_pushinteger(L, (int)mo->radius_);
+        return true;
 
-    lua_pushinteger(L, (int)value);
-    lua_setfield(L, -2, "angle"); // add to MOBJ Table
-    //---------------
+    case kLuaMapObjectFieldBenefits:
+        // monsters only want kill benefits, everything else pickup benefits
+        return CreateLuaTable_Benefits(L, mo, (mo->extended_flags_ & kExtendedFlagMonster) ? true : false);
 
-    //---------------
-    // object.mlook
-    value = epi::DegreesFromBAM(mo->vertical_angle_);
+    default:
+        return false;
+    }
+}
 
-    if (value > 180.0f)
-        value -= 360.0f;
+// FillLuaTable_Mobj(LuaState, index, mobj)
+//
+// Empties the MOBJ table at 'index' and fills it in again for 'mo', so
+// that a table can be handed out over and over without making garbage.
+void FillLuaTable_Mobj(lua_State *L, int index, MapObject *mo)
+{
+    index = lua_absindex(L, index);
 
-    lua_pushinteger(L, (int)value);
-    lua_setfield(L, -2, "mlook"); // add to MOBJ Table
-    //---------------
+    // clearing existing fields during a traversal is allowed
+    lua_pushnil(L);
+    while (lua_next(L, index) != 0)
+    {
+        lua_pop(L, 1);        // value
+        lua_pushvalue(L, -1); // key
+        lua_pushnil(L);
+        lua_rawset(L, index);
+    }
 
-    //---------------
-    // object.radius
-    lua_pushinteger(L, (int)mo->radius_);
-    lua_setfield(L, -2, "radius"); // add to MOBJ Table
-    //---------------
+    for (int field = kLuaMapObjectFieldName; field < kTotalLuaMapObjectFields; field++)
+    {
+        if (LuaPushMapObjectField(L, mo, field))
+            lua_setfield(L, index, lua_map_object_field_names[field]); // add to MOBJ Table
+    }
+}
 
-    //---------------
-    // object.benefits
-    if (mo->extended_flags_ & kExtendedFlagMonster)
-        CreateLuaTable_Benefits(L, mo, true);  // only want kill benefits
-    else
-        CreateLuaTable_Benefits(L, mo, false); // only want pickup benefits
-    //---------------
+// CreateLuaTable_Mobj(LuaState, mobj)
+//
+void CreateLuaTable_Mobj(lua_State *L, MapObject *mo)
+{
+    lua_createtable(L, 0, kTotalLuaMapObjectFields - 1); // our MOBJ table
+
+    FillLuaTable_Mobj(L, -1, mo);
 }
 
 static void CreateLuaTable_Attacks(lua_State *L, WeaponDefinition *objWep)
@@ -1978,17 +2006,9 @@ static int MO_objects_in_radius(lua_State *L)
 //
 static int MO_count(lua_State *L)
 {
-    int        thingid = (int)luaL_checknumber(L, 1);
-    MapObject *mo;
-    double     thingcount = 0;
-
-    for (mo = map_object_list_head; mo; mo = mo->next_)
-    {
-        if (mo->info_->number_ == thingid && mo->health_ > 0)
-            thingcount++;
-    }
+    int thingid = (int)luaL_checknumber(L, 1);
 
-    lua_pushinteger(L, thingcount);
+    lua_pushinteger(L, CountLiveMapObjectsOfNumber(thingid));
 
     return 1;
 }
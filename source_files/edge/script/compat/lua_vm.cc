@@ -141,6 +141,35 @@ static int  LuaDbgNOP(lua_State *L)
     return 0;
 }
 
+// Pushes the MOBJ table handed to 'function_name', filled in for 'mo'.
+// Each function gets one table, kept in the registry and refilled on
+// every call, so LUA_RUN_SCRIPT() does not make a new table per state.
+// A script which holds on to it will see it change on the next call.
+static void LuaPushMapObjectArgument(lua_State *L, const char *function_name, MapObject *mo)
+{
+    if (lua_getfield(L, LUA_REGISTRYINDEX, "__ec_mobj_tables") != LUA_TTABLE)
+    {
+        lua_pop(L, 1);
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, LUA_REGISTRYINDEX, "__ec_mobj_tables");
+    }
+
+    if (lua_getfield(L, -1, function_name) == LUA_TTABLE)
+    {
+        FillLuaTable_Mobj(L, -1, mo);
+    }
+    else
+    {
+        lua_pop(L, 1);
+        CreateLuaTable_Mobj(L, mo);
+        lua_pushvalue(L, -1);
+        lua_setfield(L, -3, function_name);
+    }
+
+    lua_remove(L, -2); // the registry table of tables
+}
+
 void LuaCallGlobalFunction(lua_State *L, const char *function_name, MapObject *mo)
 {
     // If we try and call a lua script from DDF(e.g. LUA_RUN_SCRIPT()), but are running COAL, then log a warning and do
@@ -159,7 +188,7 @@ void LuaCallGlobalFunction(lua_State *L, const char *function_name, MapObject *m
         {
             if (mo)
             {
-                CreateLuaTable_Mobj(L, mo);
+                LuaPushMapObjectArgument(L, function_name, mo);
                 status = dbg_pcall(L, 1, 0, 0);
             }
             else
@@ -173,7 +202,7 @@ void LuaCallGlobalFunction(lua_State *L, const char *function_name, MapObject *m
 
             if (mo)
             {
-                CreateLuaTable_Mobj(L, mo);
+                LuaPushMapObjectArgument(L, function_name, mo);
                 status = lua_pcall(L, 1, 0, base);
             }
             else
@@ -244,20 +273,67 @@ static void LuaSandbox(lua_State *L)
     }
 }
 
+static LuaAllocatorStats lua_allocator_stats;
+
 static void *LUA_DefaultAllocator(void *user, void *ptr, size_t osize, size_t nsize)
 {
     (void)user;
-    (void)osize; /* not used */
+
+    // when ptr is NULL, osize is the type of object being allocated
+    size_t old_size = ptr ? osize : 0;
+
     if (nsize == 0)
     {
         if (ptr)
         {
             free(ptr);
+            lua_allocator_stats.frees++;
+            lua_allocator_stats.bytes_in_use -= old_size;
         }
         return NULL;
     }
-    else
-        return realloc(ptr, nsize);
+
+    void *block = realloc(ptr, nsize);
+
+    if (block)
+    {
+        if (ptr)
+            lua_allocator_stats.reallocations++;
+        else
+            lua_allocator_stats.allocations++;
+
+        lua_allocator_stats.bytes_in_use += nsize - old_size;
+
+        if (lua_allocator_stats.bytes_in_use > lua_allocator_stats.peak_bytes)
+            lua_allocator_stats.peak_bytes = lua_allocator_stats.bytes_in_use;
+    }
+
+    return block;
+}
+
+const LuaAllocatorStats &LuaGetAllocatorStats()
+{
+    return lua_allocator_stats;
+}
+
+void LuaPrintMemoryStats()
+{
+    const LuaAllocatorStats &stats = lua_allocator_stats;
+
+    LogPrint("Lua memory:\n");
+    LogPrint("  in use        : %zu KB (peak %zu KB)\n", stats.bytes_in_use / 1024, stats.peak_bytes / 1024);
+    LogPrint("  allocations   : %llu\n", (unsigned long long)stats.allocations);
+    LogPrint("  reallocations : %llu\n", (unsigned long long)stats.reallocations);
+    LogPrint("  frees         : %llu\n", (unsigned long long)stats.frees);
+
+    lua_State *L = global_lua_state;
+
+    if (L)
+    {
+        int kb = lua_gc(L, LUA_GCCOUNT);
+        int b  = lua_gc(L, LUA_GCCOUNTB);
+        LogPrint("  gc heap       : %d.%03d KB\n", kb, b * 1000 / 1024);
+    }
 }
 
 lua_State *LuaCreateVM()
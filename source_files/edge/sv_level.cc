@@ -32,6 +32,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include "am_map.h"
 #include "ddf_colormap.h"
 #include "epi.h"
 #include "epi_str_compare.h"
@@ -498,6 +499,9 @@ void SV_LineFinaliseElems(void)
         Line *ld = level_lines + i;
         Side *s1, *s2;
 
+        // flags and special were restored
+        AutomapLineChanged(ld);
+
         s1 = ld->side[0];
         s2 = ld->side[1];
 
@@ -530,6 +534,9 @@ void SV_LineFinaliseElems(void)
 
         (*SMI)->line->slider_move = (*SMI);
     }
+
+    // line flags, doors and sliders have all changed
+    BuildSoundGraph();
 }
 
 //----------------------------------------------------------------------------
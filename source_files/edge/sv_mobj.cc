@@ -442,6 +442,8 @@ void SaveGameMapObjectFinaliseElems(void)
                 next_available_tid = mo->tid_ + 1;
         }
     }
+
+    RebuildMapObjectTypeLists();
 }
 
 //----------------------------------------------------------------------------
@@ -138,6 +138,88 @@ void COALCallFunction(coal::VM *vm, const char *name)
         FatalError("COAL script terminated with an error.\n");
 }
 
+//------------------------------------------------------------------------
+//  HANDLES
+//------------------------------------------------------------------------
+
+COALVariable coal_sys_gametic                    = {"sys", "gametic", coal::VM::NOT_FOUND};
+COALVariable coal_hud_universal_y_adjust         = {"hud", "universal_y_adjust", coal::VM::NOT_FOUND};
+COALVariable coal_hud_x_left                     = {"hud", "x_left", coal::VM::NOT_FOUND};
+COALVariable coal_hud_x_right                    = {"hud", "x_right", coal::VM::NOT_FOUND};
+COALVariable coal_player_inventory_event_handler = {"player", "inventory_event_handler", coal::VM::NOT_FOUND};
+
+COALFunction coal_draw_all = {"draw_all", coal::VM::NOT_FOUND};
+
+static void COALResolveVariable(coal::VM *vm, COALVariable &var)
+{
+    std::string full_name = var.module_name;
+    full_name += '.';
+    full_name += var.variable_name;
+
+    var.handle = vm->FindVariable(full_name.c_str());
+}
+
+static void COALResolveHandles(coal::VM *vm)
+{
+    COALResolveVariable(vm, coal_sys_gametic);
+    COALResolveVariable(vm, coal_hud_universal_y_adjust);
+    COALResolveVariable(vm, coal_hud_x_left);
+    COALResolveVariable(vm, coal_hud_x_right);
+    COALResolveVariable(vm, coal_player_inventory_event_handler);
+
+    coal_draw_all.handle = vm->FindFunction(coal_draw_all.name);
+}
+
+double COALGetFloat(coal::VM *vm, const COALVariable &var)
+{
+    double *value = vm->AccessVariable(var.handle);
+
+    if (!value)
+        return vm->GetFloat(var.module_name, var.variable_name);
+
+    return *value;
+}
+
+void COALSetFloat(coal::VM *vm, const COALVariable &var, double value)
+{
+    double *storage = vm->AccessVariable(var.handle);
+
+    if (!storage)
+    {
+        vm->SetFloat(var.module_name, var.variable_name, value);
+        return;
+    }
+
+    *storage = value;
+}
+
+void COALSetVector(coal::VM *vm, const COALVariable &var, double val_1, double val_2, double val_3)
+{
+    double *storage = vm->AccessVariable(var.handle);
+
+    if (!storage)
+    {
+        vm->SetVector(var.module_name, var.variable_name, val_1, val_2, val_3);
+        return;
+    }
+
+    storage[0] = val_1;
+    storage[1] = val_2;
+    storage[2] = val_3;
+}
+
+void COALCallFunction(coal::VM *vm, const COALFunction &func)
+{
+    if (func.handle == coal::VM::NOT_FOUND)
+    {
+        COALCallFunction(vm, func.name);
+        return;
+    }
+
+    if (vm->Execute(func.handle) != 0)
+        FatalError("COAL script terminated with an error.\n");
+}
+
 //------------------------------------------------------------------------
 //  SYSTEM MODULE
 //------------------------------------------------------------------------
@@ -481,7 +563,9 @@ void COALLoadScripts()
 
     unread_scripts.clear();
 
-    COALSetFloat(ui_vm, "sys", "gametic", game_tic);
+    COALResolveHandles(ui_vm);
+
+    COALSetFloat(ui_vm, coal_sys_gametic, game_tic);
 
     if (IsLumpInPwad("STBAR"))
     {
@@ -20,6 +20,11 @@
 
 #include <string>
 
+namespace coal
+{
+class VM;
+}
+
 // Detects COAL in a pwad or epk
 bool GetCOALDetected();
 void SetCOALDetected(bool detected);
@@ -27,12 +32,46 @@ void SetCOALDetected(bool detected);
 void InitializeCOAL();
 void ShutdownCOAL();
 
+// prints VM messages to the console, prefixed with "COAL:"
+void COALPrinter(const char *msg, ...);
+
 void COALAddScript(int type, std::string &data, const std::string &source);
 void COALLoadScripts();
 
 void COALRegisterHUD();
 void COALRegisterPlaysim();
 
+// Handles for variables and functions the engine touches every tic or
+// frame.  They are resolved once by COALLoadScripts(), after which the
+// accessors below read or write the VM storage directly.  A handle which
+// could not be resolved falls back to the by-name lookup, so the usual
+// error reporting still happens.
+struct COALVariable
+{
+    const char *module_name;
+    const char *variable_name;
+    int         handle;
+};
+
+struct COALFunction
+{
+    const char *name;
+    int         handle;
+};
+
+extern COALVariable coal_sys_gametic;
+extern COALVariable coal_hud_universal_y_adjust;
+extern COALVariable coal_hud_x_left;
+extern COALVariable coal_hud_x_right;
+extern COALVariable coal_player_inventory_event_handler;
+
+extern COALFunction coal_draw_all;
+
+double COALGetFloat(coal::VM *vm, const COALVariable &var);
+void   COALSetFloat(coal::VM *vm, const COALVariable &var, double value);
+void   COALSetVector(coal::VM *vm, const COALVariable &var, double val_1, double val_2, double val_3);
+void   COALCallFunction(coal::VM *vm, const COALFunction &func);
+
 // HUD stuff
 void COALNewGame(void);
 void COALLoadGame(void);
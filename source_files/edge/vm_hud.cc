@@ -31,6 +31,7 @@
 #include "hu_font.h"
 #include "i_system.h"
 #include "im_data.h"
+#include "m_profile.h"
 #include "r_colormap.h"
 #include "r_misc.h"
 #include "r_modes.h"
@@ -41,9 +42,6 @@
 
 extern coal::VM *ui_vm;
 
-extern void COALSetVector(coal::VM *vm, const char *mod_name, const char *var_name, double val_1, double val_2,
-                          double val_3);
-extern void COALSetFloat(coal::VM *vm, const char *mod, const char *name, double value);
 extern void COALCallFunction(coal::VM *vm, const char *name);
 
 // Needed for color functions
@@ -100,8 +98,8 @@ static void HD_coord_sys(coal::VM *vm, int argc)
 
     HUDSetCoordinateSystem(w, h);
 
-    COALSetFloat(ui_vm, "hud", "x_left", hud_x_left);
-    COALSetFloat(ui_vm, "hud", "x_right", hud_x_right);
+    COALSetFloat(ui_vm, coal_hud_x_left, hud_x_left);
+    COALSetFloat(ui_vm, coal_hud_x_right, hud_x_right);
 }
 
 // hud.game_mode()
@@ -1203,6 +1201,8 @@ void COALEndLevel(void)
 
 void COALRunHUD(void)
 {
+    EDGE_PROFILE_SCOPE("COALRunHUD");
+
     HUDReset();
 
     ui_hud_who    = players[display_player];
@@ -1212,9 +1212,9 @@ void COALRunHUD(void)
     ui_hud_automap_flags[1] = 0;
     ui_hud_automap_zoom     = -1;
 
-    COALCallFunction(ui_vm, "draw_all");
+    COALCallFunction(ui_vm, coal_draw_all);
 
-    COALSetVector(ui_vm, "player", "inventory_event_handler", 0, 0, 0);
+    COALSetVector(ui_vm, coal_player_inventory_event_handler, 0, 0, 0);
 
     HUDReset();
 }
@@ -1493,17 +1493,7 @@ static void MO_count(coal::VM *vm, int argc)
     else
         thingid = (int)*num;
 
-    MapObject *mo;
-
-    double thingcount = 0;
-
-    for (mo = map_object_list_head; mo; mo = mo->next_)
-    {
-        if (mo->info_->number_ == thingid && mo->health_ > 0)
-            thingcount++;
-    }
-
-    vm->ReturnFloat(thingcount);
+    vm->ReturnFloat(CountLiveMapObjectsOfNumber(thingid));
 }
 
 // mapobject.render_view_tag(x, y, w, h, tag)
@@ -133,8 +133,13 @@ class PackFile
 
     mz_zip_archive *archive_;
 
+    // memory mapping of the whole archive (zip only), nullptr when the
+    // platform could not map it and miniz reads the file itself.
+    epi::File *mapped_;
+
   public:
-    PackFile(DataFile *par, bool folder) : parent_(par), is_folder_(folder), directories_(), archive_(nullptr)
+    PackFile(DataFile *par, bool folder)
+        : parent_(par), is_folder_(folder), directories_(), archive_(nullptr), mapped_(nullptr)
     {
     }
 
@@ -145,6 +150,8 @@ class PackFile
             mz_zip_end(archive_);
             free(archive_);
         }
+
+        delete mapped_;
     }
 
     size_t AddDirectory(const std::string &name)
@@ -227,6 +234,9 @@ class PackFile
 
     epi::File *OpenFolderEntryByName(const std::string &name);
     epi::File *OpenZipEntryByName(const std::string &name);
+
+    epi::File *OpenZipIndex(mz_uint zip_idx);
+    epi::File *OpenStoredZipEntry(mz_uint zip_idx);
 };
 
 void ClosePackFile(DataFile *df)
@@ -403,7 +413,22 @@ static PackFile *ProcessZip(DataFile *df)
 
     mz_zip_zero_struct(pack->archive_);
 
-    if (!mz_zip_reader_init_file(pack->archive_, df->name_.c_str(), 0))
+    pack->mapped_ = epi::FileOpenMapped(df->name_);
+
+    // huge (zip64) archives are left to miniz's own file reader
+    if (pack->mapped_ && pack->mapped_->GetLength() == INT_MAX)
+    {
+        delete pack->mapped_;
+        pack->mapped_ = nullptr;
+    }
+
+    bool opened;
+    if (pack->mapped_)
+        opened = mz_zip_reader_init_mem(pack->archive_, pack->mapped_->GetDirectData(), pack->mapped_->GetLength(), 0);
+    else
+        opened = mz_zip_reader_init_file(pack->archive_, df->name_.c_str(), 0);
+
+    if (!opened)
     {
         switch (mz_zip_get_last_error(pack->archive_))
         {
@@ -608,12 +633,63 @@ class ZIPFile : public epi::File
     }
 };
 
-epi::File *PackFile::OpenZipEntry(size_t dir, size_t index)
+// Stored (uncompressed) entries of a mapped archive are returned as a
+// MemFile over the mapping itself, so reading them needs no inflate state
+// and GetDirectData() gives the bytes in place.  Returns nullptr when the
+// entry has to go through miniz.
+epi::File *PackFile::OpenStoredZipEntry(mz_uint zip_idx)
+{
+    if (!mapped_)
+        return nullptr;
+
+    mz_zip_archive_file_stat stat;
+    if (!mz_zip_reader_file_stat(archive_, zip_idx, &stat))
+        return nullptr;
+
+    if (stat.m_method != 0 || stat.m_is_encrypted || stat.m_comp_size != stat.m_uncomp_size)
+        return nullptr;
+
+    const uint8_t *base   = mapped_->GetDirectData();
+    int64_t        length = mapped_->GetLength();
+
+    // skip the local file header, whose name and extra field lengths can
+    // differ from the central directory copy.
+    int64_t header = (int64_t)stat.m_local_header_ofs;
+
+    if (header < 0 || header + 30 > length)
+        return nullptr;
+
+    const uint8_t *local = base + header;
+
+    if (local[0] != 'P' || local[1] != 'K' || local[2] != 3 || local[3] != 4)
+        return nullptr;
+
+    int name_length  = local[26] | (local[27] << 8);
+    int extra_length = local[28] | (local[29] << 8);
+
+    int64_t start = header + 30 + name_length + extra_length;
+
+    if (start + (int64_t)stat.m_uncomp_size > length || stat.m_uncomp_size > INT_MAX)
+        return nullptr;
+
+    return new epi::MemFile(base + start, (int)stat.m_uncomp_size, false);
+}
+
+epi::File *PackFile::OpenZipIndex(mz_uint zip_idx)
 {
-    ZIPFile *F = new ZIPFile(this, directories_[dir].entries_[index].zip_index_);
+    epi::File *F = OpenStoredZipEntry(zip_idx);
+
+    if (F == nullptr)
+        F = new ZIPFile(this, zip_idx);
+
     return F;
 }
 
+epi::File *PackFile::OpenZipEntry(size_t dir, size_t index)
+{
+    return OpenZipIndex(directories_[dir].entries_[index].zip_index_);
+}
+
 epi::File *PackFile::OpenZipEntryByName(const std::string &name)
 {
     // this ignores case by default
@@ -621,8 +697,7 @@ epi::File *PackFile::OpenZipEntryByName(const std::string &name)
     if (idx < 0)
         return nullptr;
 
-    ZIPFile *F = new ZIPFile(this, (mz_uint)idx);
-    return F;
+    return OpenZipIndex((mz_uint)idx);
 }
 
 //----------------------------------------------------------------------------
@@ -1251,9 +1326,22 @@ static void ProcessWADsInPack(PackFile *pack)
 
             if (pack_wad)
             {
-                uint8_t      *raw_pack_wad = pack_wad->LoadIntoMemory();
-                epi::MemFile *pack_wad_mem = new epi::MemFile(raw_pack_wad, pack_wad->GetLength(), true);
-                delete[] raw_pack_wad; // copied on pack_wad_mem creation
+                epi::File *pack_wad_mem;
+
+                // a stored entry in a mapped archive can be used in place,
+                // the pack stays open for as long as its WADs do.
+                if (pack_wad->GetDirectData())
+                {
+                    pack_wad_mem = pack_wad;
+                    pack_wad     = nullptr;
+                }
+                else
+                {
+                    uint8_t *raw_pack_wad = pack_wad->LoadIntoMemory();
+                    pack_wad_mem          = new epi::MemFile(raw_pack_wad, pack_wad->GetLength(), true);
+                    delete[] raw_pack_wad; // copied on pack_wad_mem creation
+                }
+
                 DataFile *pack_wad_df = new DataFile(
                     entry.name_, (pack->parent_->kind_ == kFileKindIFolder || pack->parent_->kind_ == kFileKindIPK)
                                      ? kFileKindIPackWAD
@@ -184,7 +184,10 @@ void ProcessFile(DataFile *df)
 
     if (df->kind_ <= kFileKindXWAD)
     {
-        epi::File *file = epi::FileOpen(filename, epi::kFileAccessRead | epi::kFileAccessBinary);
+        // prefer a memory mapping, so lumps can be used in place
+        epi::File *file = epi::FileOpenMapped(filename);
+        if (file == nullptr)
+            file = epi::FileOpen(filename, epi::kFileAccessRead | epi::kFileAccessBinary);
         if (file == nullptr)
             FatalError("Couldn't open file: %s\n", filename.c_str());
 
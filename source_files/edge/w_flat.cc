@@ -466,11 +466,15 @@ static void PrecacheTextures(void)
 //
 void PrecacheLevelGraphics(void)
 {
+    BeginImagePrecache();
+
     PrecacheSprites();
     PrecacheTextures();
     PrecacheSky();
     if (!precache_all_models.d_)
         PrecacheModels();
+
+    FinishImagePrecache();
 }
 
 //--- editor settings ---
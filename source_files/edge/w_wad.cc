@@ -2234,6 +2234,35 @@ uint8_t *LoadLumpIntoMemory(int lump, int *length)
     return data;
 }
 
+LumpView::LumpView(int lump) : data_(nullptr), owned_(nullptr), length_(0)
+{
+    if (!IsLumpIndexValid(lump))
+        FatalError("LumpView: %i >= numlumps", lump);
+
+    LumpInfo *L  = &lump_info[lump];
+    DataFile *df = data_files[L->file];
+
+    length_ = L->size;
+
+    const uint8_t *direct = df->file_->GetDirectData();
+
+    if (direct)
+    {
+        if (L->position < 0 || L->size < 0 || (int64_t)L->position + L->size > df->file_->GetLength())
+            FatalError("LumpView: lump %d lies outside of %s", lump, df->name_.c_str());
+
+        data_ = direct + L->position;
+        return;
+    }
+
+    owned_ = new uint8_t[length_ + 1];
+
+    W_RawReadLump(lump, owned_);
+
+    owned_[length_] = 0;
+    data_           = owned_;
+}
+
 uint8_t *LoadLumpIntoMemory(const char *name, int *length)
 {
     return LoadLumpIntoMemory(GetLumpNumberForName(name), length);
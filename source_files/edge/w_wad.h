@@ -82,6 +82,37 @@ uint8_t *LoadLumpIntoMemory(const char *name, int *length = nullptr);
 std::string LoadLumpAsString(int lump);
 std::string LoadLumpAsString(const char *name);
 
+// Read-only view of a lump's bytes.  When the lump's file can be addressed
+// in place (memory-mapped WADs, WADs held in memory) the view points
+// straight into it, otherwise the lump is read into a buffer owned by the
+// view.  Unlike LoadLumpIntoMemory(), the data is not zero-terminated.
+class LumpView
+{
+  private:
+    const uint8_t *data_;
+    uint8_t       *owned_;
+    int            length_;
+
+  public:
+    explicit LumpView(int lump);
+    ~LumpView()
+    {
+        delete[] owned_;
+    }
+
+    LumpView(const LumpView &)            = delete;
+    LumpView &operator=(const LumpView &) = delete;
+
+    const uint8_t *GetData() const
+    {
+        return data_;
+    }
+    int GetLength() const
+    {
+        return length_;
+    }
+};
+
 bool        IsLumpIndexValid(int lump);
 bool        VerifyLump(int lump, const char *name);
 const char *GetLumpNameFromIndex(int lump);
@@ -22,6 +22,10 @@
 
 #include "HandmadeMath.h"
 #include "epi.h"
+#include "epi_windows.h"
+#ifndef _WIN32
+#include <sys/mman.h>
+#endif
 namespace epi
 {
 
@@ -102,6 +106,80 @@ bool ANSIFile::Seek(int offset, int seekpoint)
     return (result == 0);
 }
 
+MappedFile::MappedFile(const uint8_t *data, int64_t len) : data_(data), length_(len), pos_(0)
+{
+    EPI_ASSERT(data_);
+    EPI_ASSERT(length_ > 0);
+}
+
+MappedFile::~MappedFile()
+{
+#ifdef _WIN32
+    UnmapViewOfFile(data_);
+#else
+    munmap((void *)data_, (size_t)length_);
+#endif
+    data_ = nullptr;
+}
+
+unsigned int MappedFile::Read(void *dest, unsigned int size)
+{
+    EPI_ASSERT(dest);
+
+    if (pos_ >= length_)
+        return 0; // EOF
+
+    if ((int64_t)size > length_ - pos_)
+        size = (unsigned int)(length_ - pos_);
+
+    memcpy(dest, data_ + pos_, size);
+    pos_ += size;
+
+    return size;
+}
+
+bool MappedFile::Seek(int offset, int seekpoint)
+{
+    int64_t new_pos = 0;
+
+    switch (seekpoint)
+    {
+    case kSeekpointStart: {
+        new_pos = 0;
+        break;
+    }
+    case kSeekpointCurrent: {
+        new_pos = pos_;
+        break;
+    }
+    case kSeekpointEnd: {
+        new_pos = length_;
+        break;
+    }
+
+    default:
+        return false;
+    }
+
+    new_pos += offset;
+
+    // NOTE: we allow position at the very end (last byte + 1).
+    if (new_pos < 0 || new_pos > length_)
+        return false;
+
+    pos_ = new_pos;
+
+    return true;
+}
+
+unsigned int MappedFile::Write(const void *src, unsigned int size)
+{
+    EPI_UNUSED(src);
+    EPI_UNUSED(size);
+
+    FatalError("MappedFile::Write called.\n");
+}
+
 std::string File::ReadText()
 {
     std::string textstring;
@@ -210,6 +288,16 @@ bool SubFile::Seek(int offset, int seekpoint)
     return true;
 }
 
+const uint8_t *SubFile::GetDirectData()
+{
+    const uint8_t *parent_data = parent_->GetDirectData();
+
+    if (!parent_data)
+        return nullptr;
+
+    return parent_data + start_;
+}
+
 unsigned int SubFile::Write(const void *src, unsigned int size)
 {
     EPI_UNUSED(src);
@@ -55,6 +55,14 @@ class File
 
     virtual bool Seek(int offset, int seekpoint) = 0;
 
+    // returns the whole contents when they can be addressed in place
+    // (memory-mapped or memory-backed files), otherwise nullptr.  The
+    // pointer stays valid for the lifetime of the File.
+    virtual const uint8_t *GetDirectData()
+    {
+        return nullptr;
+    }
+
   public:
     // load the file into memory, reading from the current
     // position, and reading no more than the 'max_size'
@@ -87,6 +95,42 @@ class ANSIFile : public File
     bool Seek(int offset, int seekpoint) override;
 };
 
+// read-only file mapped into memory.  Reads are copies out of the mapping,
+// and GetDirectData() lets callers use the bytes without any copy at all.
+// The size and position are 64-bit internally, the File interface still
+// reports them as int.  Create these with FileOpenMapped().
+class MappedFile : public File
+{
+  private:
+    const uint8_t *data_;
+
+    int64_t length_;
+    int64_t pos_;
+
+  public:
+    MappedFile(const uint8_t *data, int64_t len);
+    ~MappedFile() override;
+
+    int GetLength() override
+    {
+        return (int)(length_ > INT_MAX ? INT_MAX : length_);
+    }
+    int GetPosition() override
+    {
+        return (int)(pos_ > INT_MAX ? INT_MAX : pos_);
+    }
+
+    unsigned int Read(void *dest, unsigned int size) override;
+    unsigned int Write(const void *src, unsigned int size) override;
+
+    bool Seek(int offset, int seekpoint) override;
+
+    const uint8_t *GetDirectData() override
+    {
+        return data_;
+    }
+};
+
 class SubFile : public File
 {
   private:
@@ -113,6 +157,8 @@ class SubFile : public File
     unsigned int Write(const void *src, unsigned int size) override;
 
     bool Seek(int offset, int seekpoint) override;
+
+    const uint8_t *GetDirectData() override;
 };
 
 class MemFile : public File
@@ -141,6 +187,11 @@ class MemFile : public File
     unsigned int Write(const void *src, unsigned int size) override;
 
     bool Seek(int offset, int seekpoint) override;
+
+    const uint8_t *GetDirectData() override
+    {
+        return data_;
+    }
 };
 
 } // namespace epi
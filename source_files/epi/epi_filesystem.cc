@@ -28,7 +28,9 @@
 #endif
 #ifndef _WIN32
 #include <dirent.h>
+#include <fcntl.h>
 #include <ftw.h>
+#include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
@@ -108,6 +110,13 @@ bool FileDelete(std::string_view name)
     std::wstring wname = epi::UTF8ToWString(name);
     return _wremove(wname.c_str()) == 0;
 }
+bool FileRename(std::string_view src, std::string_view dest)
+{
+    EPI_ASSERT(!src.empty() && !dest.empty());
+    std::wstring wsrc  = epi::UTF8ToWString(src);
+    std::wstring wdest = epi::UTF8ToWString(dest);
+    return MoveFileExW(wsrc.c_str(), wdest.c_str(), MOVEFILE_REPLACE_EXISTING) != 0;
+}
 std::string CurrentDirectoryGet()
 {
     std::string directory;
@@ -159,6 +168,10 @@ bool TestFileAccess(std::string_view name)
     else
         return false;
 }
+static uint64_t FileTimeValue(const FILETIME &ft)
+{
+    return ((uint64_t)ft.dwHighDateTime << 32) | ft.dwLowDateTime;
+}
 bool ReadDirectory(std::vector<DirectoryEntry> &fsd, const std::string &dir, const char *mask)
 {
     if (dir.empty() || !FileExists(dir) || !mask)
@@ -182,9 +195,10 @@ bool ReadDirectory(std::vector<DirectoryEntry> &fsd, const std::string &dir, con
         else
         {
             epi::DirectoryEntry new_entry;
-            new_entry.name   = dir;
-            new_entry.is_dir = (fdataw.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? true : false;
-            new_entry.size   = new_entry.is_dir ? 0 : fdataw.nFileSizeLow;
+            new_entry.name     = dir;
+            new_entry.is_dir   = (fdataw.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) ? true : false;
+            new_entry.size     = new_entry.is_dir ? 0 : fdataw.nFileSizeLow;
+            new_entry.modified = FileTimeValue(fdataw.ftLastWriteTime);
             if (!IsDirectorySeparator(filename[0]))
                 new_entry.name.push_back('/');
             new_entry.name.append(filename);
@@ -225,9 +239,10 @@ bool WalkDirectory(std::vector<DirectoryEntry> &fsd, const std::string &dir)
         else
         {
             epi::DirectoryEntry new_entry;
-            new_entry.name   = dir;
-            new_entry.is_dir = false;
-            new_entry.size   = fdataw.nFileSizeLow;
+            new_entry.name     = dir;
+            new_entry.is_dir   = false;
+            new_entry.size     = fdataw.nFileSizeLow;
+            new_entry.modified = FileTimeValue(fdataw.ftLastWriteTime);
             if (!IsDirectorySeparator(filename[0]))
                 new_entry.name.push_back('/');
             new_entry.name.append(filename);
@@ -294,6 +309,11 @@ bool FileDelete(std::string_view name)
     EPI_ASSERT(!name.empty());
     return remove(std::string(name).c_str()) == 0;
 }
+bool FileRename(std::string_view src, std::string_view dest)
+{
+    EPI_ASSERT(!src.empty() && !dest.empty());
+    return rename(std::string(src).c_str(), std::string(dest).c_str()) == 0;
+}
 #ifndef EDGE_WEB
 std::string CurrentDirectoryGet()
 {
@@ -373,9 +393,10 @@ bool ReadDirectory(std::vector<DirectoryEntry> &fsd, const std::string &dir, con
             continue;
 
         epi::DirectoryEntry new_entry;
-        new_entry.name   = filename;
-        new_entry.is_dir = S_ISDIR(finfo.st_mode) ? true : false;
-        new_entry.size   = finfo.st_size;
+        new_entry.name     = filename;
+        new_entry.is_dir   = S_ISDIR(finfo.st_mode) ? true : false;
+        new_entry.size     = finfo.st_size;
+        new_entry.modified = (uint64_t)finfo.st_mtime;
         fsd.push_back(new_entry);
     }
 
@@ -392,9 +413,10 @@ static int WalkDirectoryCallback(const char *filename, const struct stat *stat_p
         FTW_F) // The documentation for nftw refers to these as flags but I think it can only be one of them - Dasho
     {
         epi::DirectoryEntry new_entry;
-        new_entry.name   = filename;
-        new_entry.is_dir = false;
-        new_entry.size   = stat_pointer->st_size;
+        new_entry.name     = filename;
+        new_entry.is_dir   = false;
+        new_entry.size     = stat_pointer->st_size;
+        new_entry.modified = (uint64_t)stat_pointer->st_mtime;
         nftw_fsd->push_back(new_entry);
     }
     return 0;
@@ -618,6 +640,61 @@ File *FileOpen(std::string_view name, unsigned int flags)
     return new ANSIFile(fp);
 }
 
+File *FileOpenMapped(std::string_view name)
+{
+    EPI_ASSERT(!name.empty());
+#if defined(EDGE_WEB)
+    // virtual filesystem, nothing to gain from mapping
+    return nullptr;
+#elif defined(_WIN32)
+    std::wstring wname = epi::UTF8ToWString(name);
+
+    HANDLE handle = CreateFileW(wname.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (handle == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(handle, &size) || size.QuadPart <= 0)
+    {
+        CloseHandle(handle);
+        return nullptr;
+    }
+
+    HANDLE mapping = CreateFileMappingW(handle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(handle);
+    if (!mapping)
+        return nullptr;
+
+    // the view keeps the mapping alive after its handle is closed
+    const uint8_t *data = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!data)
+        return nullptr;
+
+    return new MappedFile(data, (int64_t)size.QuadPart);
+#else
+    int fd = open(std::string(name).c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullptr;
+
+    struct stat info;
+    if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode) || info.st_size <= 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    // the mapping stays valid after the descriptor is closed
+    void *data = mmap(nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED)
+        return nullptr;
+
+    return new MappedFile((const uint8_t *)data, (int64_t)info.st_size);
+#endif
+}
+
 bool OpenDirectory(const std::string &src)
 {
     // A result of 0 is 'success', but that only means SDL was able to launch
@@ -41,8 +41,9 @@ class File;
 struct DirectoryEntry
 {
     std::string name;
-    size_t      size   = 0;
-    bool        is_dir = false;
+    size_t      size     = 0;
+    bool        is_dir   = false;
+    uint64_t    modified = 0; // only meaningful for comparing entries
 };
 
 // Path and Filename Functions
@@ -71,10 +72,16 @@ bool OpenDirectory(const std::string &src); // Opens a directory in explorer, fi
 bool  FileExists(std::string_view name);
 bool  TestFileAccess(std::string_view name);
 File *FileOpen(std::string_view name, unsigned int flags);
+// Opens an existing file read-only as a MappedFile.  Returns nullptr if the
+// file cannot be mapped (missing, empty, or no mmap on this platform), in
+// which case the caller should fall back to FileOpen().
+File *FileOpenMapped(std::string_view name);
 FILE *FileOpenRaw(std::string_view name, unsigned int flags);
 // NOTE: there's no CloseFile function, just delete the object.
 bool FileCopy(std::string_view src, std::string_view dest);
 bool FileDelete(std::string_view name);
+// Replaces 'dest' if it already exists.
+bool FileRename(std::string_view src, std::string_view dest);
 
 // General Filesystem Functions
 // Performs a sync for platforms with virtualized file systems
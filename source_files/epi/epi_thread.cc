@@ -0,0 +1,150 @@
+//----------------------------------------------------------------------------
+//  EDGE Worker Thread Pool
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#include "epi_thread.h"
+
+#include "HandmadeMath.h"
+#include "epi.h"
+
+namespace epi
+{
+
+static constexpr int kMaximumWorkerThreads = 16;
+
+WorkerPool::WorkerPool(int thread_count) : busy_(0), quit_(false)
+{
+    mutex_      = SDL_CreateMutex();
+    work_ready_ = SDL_CreateCond();
+    work_done_  = SDL_CreateCond();
+
+#ifdef EPI_THREADS
+    if (thread_count <= 0)
+        thread_count = SDL_GetCPUCount() - 1;
+
+    thread_count = HMM_Clamp(0, thread_count, kMaximumWorkerThreads);
+
+    for (int i = 0; i < thread_count; i++)
+    {
+        SDL_Thread *thread = SDL_CreateThread(ThreadProc, "EDGE Worker", this);
+
+        if (!thread)
+        {
+            LogWarning("WorkerPool: unable to create thread: %s\n", SDL_GetError());
+            break;
+        }
+
+        threads_.push_back(thread);
+    }
+#else
+    EPI_UNUSED(thread_count);
+#endif
+}
+
+WorkerPool::~WorkerPool()
+{
+    SDL_LockMutex(mutex_);
+    quit_ = true;
+    SDL_UnlockMutex(mutex_);
+    SDL_CondBroadcast(work_ready_);
+
+    for (SDL_Thread *thread : threads_)
+        SDL_WaitThread(thread, nullptr);
+
+    SDL_DestroyCond(work_done_);
+    SDL_DestroyCond(work_ready_);
+    SDL_DestroyMutex(mutex_);
+}
+
+int WorkerPool::ThreadProc(void *data)
+{
+    WorkerPool *pool = (WorkerPool *)data;
+
+    SDL_LockMutex(pool->mutex_);
+
+    for (;;)
+    {
+        while (pool->queue_.empty() && !pool->quit_)
+            SDL_CondWait(pool->work_ready_, pool->mutex_);
+
+        if (pool->quit_)
+            break;
+
+        WorkerJob *job = pool->queue_.front();
+        pool->queue_.pop_front();
+        pool->busy_++;
+
+        SDL_UnlockMutex(pool->mutex_);
+
+        job->Run();
+
+        SDL_LockMutex(pool->mutex_);
+
+        job->finished_ = true;
+        pool->busy_--;
+
+        SDL_CondBroadcast(pool->work_done_);
+    }
+
+    SDL_UnlockMutex(pool->mutex_);
+
+    return 0;
+}
+
+void WorkerPool::Add(WorkerJob *job)
+{
+    EPI_ASSERT(job);
+
+    if (threads_.empty())
+    {
+        job->Run();
+        job->finished_ = true;
+        return;
+    }
+
+    SDL_LockMutex(mutex_);
+    job->finished_ = false;
+    queue_.push_back(job);
+    SDL_UnlockMutex(mutex_);
+
+    SDL_CondSignal(work_ready_);
+}
+
+void WorkerPool::Wait(WorkerJob *job)
+{
+    SDL_LockMutex(mutex_);
+
+    while (!job->finished_)
+        SDL_CondWait(work_done_, mutex_);
+
+    SDL_UnlockMutex(mutex_);
+}
+
+void WorkerPool::WaitAll()
+{
+    SDL_LockMutex(mutex_);
+
+    while (!queue_.empty() || busy_ > 0)
+        SDL_CondWait(work_done_, mutex_);
+
+    SDL_UnlockMutex(mutex_);
+}
+
+} // namespace epi
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab
@@ -0,0 +1,95 @@
+//----------------------------------------------------------------------------
+//  EDGE Worker Thread Pool
+//----------------------------------------------------------------------------
+//
+//  Copyright (c) 2024 The EDGE Team.
+//
+//  This program is free software; you can redistribute it and/or
+//  modify it under the terms of the GNU General Public License
+//  as published by the Free Software Foundation; either version 3
+//  of the License, or (at your option) any later version.
+//
+//  This program is distributed in the hope that it will be useful,
+//  but WITHOUT ANY WARRANTY; without even the implied warranty of
+//  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//  GNU General Public License for more details.
+//
+//----------------------------------------------------------------------------
+
+#pragma once
+
+#include <deque>
+#include <vector>
+
+#include "epi_sdl.h"
+
+#if !defined(EDGE_WEB) || defined(EDGE_WEB_MULTITHREADED)
+#define EPI_THREADS
+#endif
+
+namespace epi
+{
+
+// A unit of work for the WorkerPool.  The pool never takes ownership
+// of a job; the caller must keep it alive until Wait() returns for it.
+class WorkerJob
+{
+    friend class WorkerPool;
+
+  private:
+    // guarded by the owning pool's mutex
+    bool finished_ = true;
+
+  public:
+    WorkerJob()
+    {
+    }
+    virtual ~WorkerJob()
+    {
+    }
+
+    // Called on a worker thread (or inline when the pool has no threads).
+    virtual void Run() = 0;
+};
+
+class WorkerPool
+{
+  private:
+    std::vector<SDL_Thread *> threads_;
+
+    SDL_mutex *mutex_;
+    SDL_cond  *work_ready_;
+    SDL_cond  *work_done_;
+
+    std::deque<WorkerJob *> queue_;
+
+    int  busy_;
+    bool quit_;
+
+    static int ThreadProc(void *data);
+
+  public:
+    // thread_count <= 0 picks one worker per spare CPU core.  When threads
+    // are unavailable (e.g. single-threaded web builds) the pool has no
+    // workers and jobs run inline in Add().
+    WorkerPool(int thread_count = 0);
+    ~WorkerPool();
+
+    int GetThreadCount() const
+    {
+        return (int)threads_.size();
+    }
+
+    void Add(WorkerJob *job);
+
+    // blocks until the given job has finished
+    void Wait(WorkerJob *job);
+
+    // blocks until every queued job has finished
+    void WaitAll();
+};
+
+} // namespace epi
+
+//--- editor settings ---
+// vi:ts=4:sw=4:noexpandtab